@@ -12,6 +12,14 @@
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Core/DebugRenderSystem.hpp"
 #include "Engine/Core/JobSystem.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/ChunkLifecycle.hpp"
+#include "Game/Flythrough.hpp"
+#include "Game/JobTelemetry.hpp"
+#include "Game/MemoryStats.hpp"
+#include "Game/PerfCounters.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/WorldFingerprint.hpp"
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 App*          g_theApp = nullptr;				
@@ -74,6 +82,15 @@ void App::Startup()
 	g_theGame = new Game();
 	g_theGame->Startup();
 
+	Benchmark::RegisterCommands();
+	Flythrough::RegisterRecordCommands();
+	ChunkLifecycle::RegisterCommands();
+	JobTelemetry::RegisterCommands();
+	MemoryStats::RegisterCommands();
+	PerfCounters::RegisterCommands();
+	Profiler::RegisterCommands();
+	WorldFingerprint::RegisterCommands();
+
 	PrintDevConsoleCommands();
 }
 
@@ -125,6 +142,7 @@ App::~App()
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void App::RunFrame()
 {
+	PROFILE_SCOPE("App::RunFrame");
 	BeginFrame();
 	Update();
 	Render();
@@ -241,6 +259,24 @@ void App::PrintDevConsoleCommands()
 	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "Pitch-UP/DOWN");
 	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "Turn-LEFT/RIGHT");
 	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "Quit-Escape");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkGeneration seeds=1,2,3 threads=1,2,4 radius=3 columnCache=true noiseTiles=true climateLattice=0 caveCache=true");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkMesh iterations=20 fixture=all|plains|mountains|caves|ocean|checkerboard");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkLighting seed=1 radius=10");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkChunkIO chunks=4000 seed=424242 threads=1 keep=false");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkNoise seed=1 radius=3");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkClimateLattice seed=1 radius=3 maxError=0.01");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkCaveStarts seed=1 radius=1 checkRadius=40");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkOres seed=1 radius=3");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "BenchmarkSpawn seeds=1,2,3 threads=8 bands=1,2,4,8");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "FlythroughRecord file=Saves/Flythroughs/Flythrough.fly (toggles, replay it with the headless build)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "ChunkLifecycle reset=false (per-stage latency from chunk request to first mesh)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "JobTelemetry reset=false (chunk job queue depth, latency and per-thread busy time)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "MemoryStats reset=false (current and high-water bytes per structure)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "MemoryChunks count=20 file=Saves/MemoryChunks.csv (per-chunk memory breakdown, largest first)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "PerfCounters (toggles the per-frame counter histograms)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "PerfCountersCSV file=Saves/PerfCounters.csv (toggles streaming one row per frame)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "ProfilerTrace file=Saves/Traces/Trace.json (toggles, open in chrome://tracing)");
+	g_theDevConsole->AddLine(Rgba8(0, 255, 0, 255), "WorldFingerprint seed=1 radius=4 update=false (hashes generated chunks against a golden file)");
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -0,0 +1,1132 @@
+#include "Game/Benchmark.hpp"
+#include "Game/Chunks.hpp"
+#include "Game/BlockDef.hpp"
+#include "Game/BlockIterator.hpp"
+#include "Game/CaveCache.hpp"
+#include "Game/ColumnCache.hpp"
+#include "Game/World.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/NoiseTile.hpp"
+#include "Game/OreField.hpp"
+#include "ThirdParty/Squirrel/SmoothNoise.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class BenchmarkGenerationJob : public Job
+{
+public:
+	BenchmarkGenerationJob(IntVec2 const& chunkCoords, unsigned int worldSeed, ColumnCache* columnCache, CaveCache* caveCache) :
+		Job(CHUNK_GENERATION_JOB_TYPE),
+		m_chunkCoords(chunkCoords),
+		m_worldSeed(worldSeed),
+		m_columnCache(columnCache),
+		m_caveCache(caveCache) {}
+
+	virtual void Execute() override;
+	virtual void OnFinished() override {}
+
+	IntVec2		 m_chunkCoords;
+	unsigned int m_worldSeed = 0;
+	ColumnCache* m_columnCache = nullptr;
+	CaveCache*	 m_caveCache = nullptr;
+	double		 m_terrainSeconds = 0.0;
+	double		 m_treeSeconds = 0.0;
+	double		 m_caveSeconds = 0.0;
+	double		 m_totalSeconds = 0.0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void BenchmarkGenerationJob::Execute()
+{
+	double startTime = GetCurrentTimeSeconds();
+	Chunk* chunk = new Chunk(m_chunkCoords, m_worldSeed);
+	chunk->m_columnCache = m_columnCache;
+	chunk->m_caveCache = m_caveCache;
+
+	double terrainStartTime = GetCurrentTimeSeconds();
+	chunk->GenerateTerrain();
+	double caveStartTime = GetCurrentTimeSeconds();
+	chunk->AddCaves(chunk->GetWorldCaveSeed());
+	double treeStartTime = GetCurrentTimeSeconds();
+	chunk->AddTrees();
+	double endTime = GetCurrentTimeSeconds();
+
+	delete chunk;
+
+	m_terrainSeconds = caveStartTime - terrainStartTime;
+	m_caveSeconds = treeStartTime - caveStartTime;
+	m_treeSeconds = endTime - treeStartTime;
+	m_totalSeconds = endTime - startTime;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// One row band of a spawn chunk's terrain, or all of it when numBands is 1. The band that completes the terrain runs the
+// later stages right away, since the benchmark's chunks have no neighbors to wait for; the chunk is owned by the benchmark
+class BenchmarkSpawnBandJob : public Job
+{
+public:
+	BenchmarkSpawnBandJob(Chunk* chunk, int bandIndex, int numBands) :
+		Job(CHUNK_GENERATION_JOB_TYPE),
+		m_chunk(chunk),
+		m_bandIndex(bandIndex),
+		m_numBands(numBands) {}
+
+	virtual void Execute() override;
+	virtual void OnFinished() override {}
+
+	Chunk*	m_chunk = nullptr;
+	int		m_bandIndex = 0;
+	int		m_numBands = 1;
+	bool	m_completesChunk = false;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void BenchmarkSpawnBandJob::Execute()
+{
+	if (m_numBands <= 1)
+	{
+		m_chunk->RunGenerationStage(GENERATION_STAGE_TERRAIN);
+		m_completesChunk = true;
+	}
+	else
+	{
+		m_completesChunk = m_chunk->GenerateBlocksBand(m_bandIndex, m_numBands);
+	}
+
+	if (m_completesChunk)
+	{
+		for (int stageIndex = GENERATION_STAGE_CARVE; stageIndex < NUM_GENERATION_STAGES; stageIndex++)
+		{
+			m_chunk->RunGenerationStage(ChunkGenerationStage(stageIndex));
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Benchmark::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkGeneration", Benchmark::Event_BenchmarkGeneration);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkMesh", Benchmark::Event_BenchmarkMesh);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkLighting", Benchmark::Event_BenchmarkLighting);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkChunkIO", Benchmark::Event_BenchmarkChunkIO);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkNoise", Benchmark::Event_BenchmarkNoise);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkClimateLattice", Benchmark::Event_BenchmarkClimateLattice);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkCaveStarts", Benchmark::Event_BenchmarkCaveStarts);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkOres", Benchmark::Event_BenchmarkOres);
+	g_theEventSystem->SubscribeEventCallbackFunction("BenchmarkSpawn", Benchmark::Event_BenchmarkSpawn);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkGeneration seeds=1,2,3 threads=1,2,4 radius=3 columnCache=true noiseTiles=true climateLattice=0 caveCache=true
+//	Generates the (2*radius+1)^2 chunks around the origin once per seed and thread count, on a private JobSystem so the
+//	running world's workers are not involved. Reports chunks/sec, p50/p99 per-chunk latency and the terrain/tree/cave split.
+//	Each run starts from empty column and cave caches; columnCache=false computes every column per pass as before and
+//	caveCache=false crawls every nearby cave again for each chunk.
+//	noiseTiles=false fills the cache with scalar noise instead of the batched tile kernel.
+//	climateLattice=4 interpolates the climate layers from every 4th column (see BenchmarkClimateLattice).
+bool Benchmark::Event_BenchmarkGeneration(EventArgs& args)
+{
+	std::string defaultThreads = Stringf("1,2,4,%u", std::thread::hardware_concurrency());
+	std::vector<int> seeds = ParseIntList(args.GetValue("seeds", std::string("1,2,3")));
+	std::vector<int> threadCounts = ParseIntList(args.GetValue("threads", defaultThreads));
+	int gridRadius = args.GetValue("radius", 3);
+	bool useColumnCache = args.GetValue("columnCache", true);
+	bool useCaveCache = args.GetValue("caveCache", true);
+	ColumnCacheConfig columnConfig;
+	columnConfig.m_useNoiseTiles = args.GetValue("noiseTiles", true);
+	columnConfig.m_climateLatticeSpacing = args.GetValue("climateLattice", 0);
+
+	std::vector<IntVec2> chunkCoordsList;
+	for (int chunkY = -gridRadius; chunkY <= gridRadius; chunkY++)
+	{
+		for (int chunkX = -gridRadius; chunkX <= gridRadius; chunkX++)
+		{
+			chunkCoordsList.push_back(IntVec2(chunkX, chunkY));
+		}
+	}
+	int numChunks = (int)chunkCoordsList.size();
+
+	PrintToConsole(Stringf("BenchmarkGeneration: %i chunks per run, %i seeds, %i thread counts", numChunks, (int)seeds.size(), (int)threadCounts.size()), Rgba8(0, 255, 255, 255));
+
+	for (int threadIndex = 0; threadIndex < (int)threadCounts.size(); threadIndex++)
+	{
+		int numThreads = std::max(threadCounts[threadIndex], 1);
+
+		JobSystemConfig jobSystemConfig;
+		jobSystemConfig.m_numWorkerThreads = numThreads;
+		JobSystem* jobSystem = new JobSystem(jobSystemConfig);
+		jobSystem->Startup();
+		for (int jobThreadId = 0; jobThreadId < jobSystem->GetNumThreads(); jobThreadId++)
+		{
+			jobSystem->SetThreadJobType(jobThreadId, CHUNK_GENERATION_JOB_TYPE);
+		}
+
+		for (int seedIndex = 0; seedIndex < (int)seeds.size(); seedIndex++)
+		{
+			unsigned int worldSeed = static_cast<unsigned int>(seeds[seedIndex]);
+
+			columnConfig.m_worldSeed = worldSeed;
+			ColumnCache* columnCache = useColumnCache ? new ColumnCache(columnConfig) : nullptr;
+			CaveCache* caveCache = useCaveCache ? new CaveCache(Chunk::GetWorldCaveSeedForWorldSeed(worldSeed)) : nullptr;
+
+			double runStartTime = GetCurrentTimeSeconds();
+			for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+			{
+				jobSystem->QueueJob(new BenchmarkGenerationJob(chunkCoordsList[chunkIndex], worldSeed, columnCache, caveCache));
+			}
+
+			std::vector<double> latencies;
+			latencies.reserve(numChunks);
+			double terrainSeconds = 0.0;
+			double treeSeconds = 0.0;
+			double caveSeconds = 0.0;
+			while ((int)latencies.size() < numChunks)
+			{
+				Job* completedJob = jobSystem->RetrieveCompletedJobs();
+				if (completedJob == nullptr)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				BenchmarkGenerationJob* generationJob = (BenchmarkGenerationJob*)completedJob;
+				latencies.push_back(generationJob->m_totalSeconds);
+				terrainSeconds += generationJob->m_terrainSeconds;
+				treeSeconds += generationJob->m_treeSeconds;
+				caveSeconds += generationJob->m_caveSeconds;
+				delete completedJob;
+			}
+			double runSeconds = GetCurrentTimeSeconds() - runStartTime;
+			delete columnCache;
+			delete caveCache;
+
+			std::sort(latencies.begin(), latencies.end());
+			double phaseSeconds = terrainSeconds + treeSeconds + caveSeconds;
+			if (phaseSeconds <= 0.0)
+			{
+				phaseSeconds = 1.0;
+			}
+
+			PrintToConsole(Stringf("seed=%u threads=%i: %.1f chunks/sec, p50=%.2fms p99=%.2fms, terrain=%.0f%% trees=%.0f%% caves=%.0f%%",
+				worldSeed, numThreads, (double)numChunks / runSeconds,
+				1000.0 * GetPercentile(latencies, 0.5f), 1000.0 * GetPercentile(latencies, 0.99f),
+				100.0 * terrainSeconds / phaseSeconds, 100.0 * treeSeconds / phaseSeconds, 100.0 * caveSeconds / phaseSeconds));
+		}
+
+		jobSystem->ShutDown();
+		delete jobSystem;
+	}
+
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static char const* const MESH_FIXTURE_NAMES[] = { "plains", "mountains", "caves", "ocean", "checkerboard" };
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void FillMeshFixture(Chunk* chunk, std::string const& fixtureName)
+{
+	static BlockDefID air = BlockDef::GetBlockDefIDByName("air");
+	static BlockDefID stone = BlockDef::GetBlockDefIDByName("stone");
+	static BlockDefID dirt = BlockDef::GetBlockDefIDByName("dirt");
+	static BlockDefID grass = BlockDef::GetBlockDefIDByName("grass");
+	static BlockDefID sand = BlockDef::GetBlockDefIDByName("sand");
+	static BlockDefID water = BlockDef::GetBlockDefIDByName("water");
+
+	int chunkMinsGlobalX = chunk->m_chunkCoords.x * CHUNK_SIZE_X;
+	int chunkMinsGlobalY = chunk->m_chunkCoords.y * CHUNK_SIZE_Y;
+
+	for (int localY = 0; localY < CHUNK_SIZE_Y; localY++)
+	{
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			float globalX = float(chunkMinsGlobalX + localX);
+			float globalY = float(chunkMinsGlobalY + localY);
+
+			int groundHeightZ = SEA_LEVEL;
+			if (fixtureName == "mountains")
+			{
+				groundHeightZ = SEA_LEVEL + int(30.f * sinf(globalX * 0.21f) * cosf(globalY * 0.17f)) + int(20.f * sinf((globalX + globalY) * 0.05f));
+			}
+			else if (fixtureName == "caves")
+			{
+				groundHeightZ = CHUNK_MAX_Z - 8;
+			}
+			else if (fixtureName == "ocean")
+			{
+				groundHeightZ = SEA_LEVEL / 2;
+			}
+
+			for (int localZ = 0; localZ < CHUNK_SIZE_Z; localZ++)
+			{
+				BlockDefID blockType = air;
+				if (fixtureName == "checkerboard")
+				{
+					blockType = ((localX + localY + localZ) & 1) ? stone : air;
+				}
+				else if (fixtureName == "ocean")
+				{
+					blockType = (localZ <= groundHeightZ) ? sand : ((localZ <= SEA_LEVEL) ? water : air);
+				}
+				else if (fixtureName == "caves")
+				{
+					blockType = (localZ <= groundHeightZ) ? stone : air;
+				}
+				else if (localZ < groundHeightZ - 3)
+				{
+					blockType = stone;
+				}
+				else if (localZ < groundHeightZ)
+				{
+					blockType = dirt;
+				}
+				else if (localZ == groundHeightZ)
+				{
+					blockType = grass;
+				}
+				chunk->SetBlockType(localX, localY, localZ, blockType);
+			}
+		}
+	}
+
+	//Cave tunnels are laid out in world space so they run continuously through the neighbor chunks as well
+	if (fixtureName == "caves")
+	{
+		for (int tunnelIndex = 0; tunnelIndex < 24; tunnelIndex++)
+		{
+			float tunnelZ = 10.f + 4.5f * float(tunnelIndex);
+			float offset = 5.f * float(tunnelIndex % 6);
+			Vec3 tunnelStart(-40.f + offset, -30.f + 2.f * offset, tunnelZ);
+			Vec3 tunnelEnd(40.f - offset, 30.f - offset, tunnelZ + 6.f);
+			chunk->CarveCapsule3D(tunnelStart, tunnelEnd, 2.5f + 0.25f * float(tunnelIndex % 4));
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkMesh iterations=20 fixture=all
+//	Fills the chunk at (0,0) and its four neighbors with a canned fixture, wires them through m_northNeighbor etc. and times
+//	Chunk::RebuildMesh on the center chunk. Reports vertices emitted, ns/block and the bytes held by m_cpuMesh.
+bool Benchmark::Event_BenchmarkMesh(EventArgs& args)
+{
+	int numIterations = std::max(args.GetValue("iterations", 20), 1);
+	std::string fixtureFilter = args.GetValue("fixture", std::string("all"));
+
+	for (int fixtureIndex = 0; fixtureIndex < (int)(sizeof(MESH_FIXTURE_NAMES) / sizeof(MESH_FIXTURE_NAMES[0])); fixtureIndex++)
+	{
+		std::string fixtureName = MESH_FIXTURE_NAMES[fixtureIndex];
+		if (fixtureFilter != "all" && fixtureFilter != fixtureName)
+		{
+			continue;
+		}
+
+		Chunk* centerChunk = new Chunk(IntVec2(0, 0), 0);
+		Chunk* northChunk = new Chunk(IntVec2(0, 1), 0);
+		Chunk* southChunk = new Chunk(IntVec2(0, -1), 0);
+		Chunk* eastChunk = new Chunk(IntVec2(1, 0), 0);
+		Chunk* westChunk = new Chunk(IntVec2(-1, 0), 0);
+		centerChunk->m_northNeighbor = northChunk;
+		centerChunk->m_southNeighbor = southChunk;
+		centerChunk->m_eastNeighbor = eastChunk;
+		centerChunk->m_westNeighbor = westChunk;
+		northChunk->m_southNeighbor = centerChunk;
+		southChunk->m_northNeighbor = centerChunk;
+		eastChunk->m_westNeighbor = centerChunk;
+		westChunk->m_eastNeighbor = centerChunk;
+
+		FillMeshFixture(centerChunk, fixtureName);
+		FillMeshFixture(northChunk, fixtureName);
+		FillMeshFixture(southChunk, fixtureName);
+		FillMeshFixture(eastChunk, fixtureName);
+		FillMeshFixture(westChunk, fixtureName);
+
+		//The first build starts from an empty m_cpuMesh, so it also pays for every reallocation
+		double firstStartTime = GetCurrentTimeSeconds();
+		centerChunk->RebuildMesh();
+		double firstBuildSeconds = GetCurrentTimeSeconds() - firstStartTime;
+		size_t meshBytes = centerChunk->m_cpuMesh.capacity() * sizeof(Vertex_PCU);
+
+		std::vector<double> buildTimes;
+		buildTimes.reserve(numIterations);
+		for (int iteration = 0; iteration < numIterations; iteration++)
+		{
+			centerChunk->SetChunkToDirty();
+			double startTime = GetCurrentTimeSeconds();
+			centerChunk->RebuildMesh();
+			buildTimes.push_back(GetCurrentTimeSeconds() - startTime);
+		}
+		std::sort(buildTimes.begin(), buildTimes.end());
+
+		double nsPerBlockScale = 1.0e9 / (double)CHUNK_BLOCKS_TOTAL;
+		PrintToConsole(Stringf("BenchmarkMesh %-12s: vertices=%i, first=%.1f ns/block, p50=%.1f ns/block, p99=%.1f ns/block, m_cpuMesh=%.1f KB",
+			fixtureName.c_str(), centerChunk->GetChunkMeshVertices(),
+			firstBuildSeconds * nsPerBlockScale, GetPercentile(buildTimes, 0.5f) * nsPerBlockScale, GetPercentile(buildTimes, 0.99f) * nsPerBlockScale,
+			(double)meshBytes / 1024.0));
+
+		delete centerChunk;
+		delete northChunk;
+		delete southChunk;
+		delete eastChunk;
+		delete westChunk;
+	}
+
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void ResetLightingCounters(World* world, double& startTime)
+{
+	world->m_numLightQueuePushes = 0;
+	world->m_numLightRecomputes = 0;
+	startTime = GetCurrentTimeSeconds();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void PrintLightingScenario(World* world, char const* scenarioName, double startTime)
+{
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+	PrintToConsole(Stringf("BenchmarkLighting %-16s: queuePushes=%i, recomputes=%i, wall=%.2fms", scenarioName,
+		world->m_numLightQueuePushes, world->m_numLightRecomputes, 1000.0 * elapsedSeconds));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void DigBlockForBenchmark(World* world, Chunk* chunk, int localX, int localY, int localZ)
+{
+	static BlockDefID air = BlockDef::GetBlockDefIDByName("air");
+	chunk->SetBlockType(localX, localY, localZ, air);
+	chunk->DigBlock(BlockIterator(chunk, Chunk::GetBlockIndex(localX, localY, localZ)));
+	world->ProcessDirtyLighting();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void PlaceBlockForBenchmark(World* world, Chunk* chunk, int localX, int localY, int localZ, BlockDefID blockType)
+{
+	chunk->SetBlockType(localX, localY, localZ, blockType);
+	chunk->ProcessLightingForAddedBlock(BlockIterator(chunk, Chunk::GetBlockIndex(localX, localY, localZ)));
+	world->ProcessDirtyLighting();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkLighting seed=1 radius=10
+//	Builds a private world of (2*radius)^2 generated chunks that does not touch the job system, then runs four scenarios
+//	through the real lighting entry points. Each dig/place is followed by ProcessDirtyLighting, the way one frame would.
+bool Benchmark::Event_BenchmarkLighting(EventArgs& args)
+{
+	static BlockDefID air = BlockDef::GetBlockDefIDByName("air");
+	static BlockDefID stone = BlockDef::GetBlockDefIDByName("stone");
+	static BlockDefID glowstone = BlockDef::GetBlockDefIDByName("glowstone");
+
+	int worldSeed = args.GetValue("seed", 1);
+	int chunkRadius = std::max(args.GetValue("radius", 10), 4);
+
+	World* world = new World(false);
+	world->m_worldSeed = worldSeed;
+
+	for (int chunkY = -chunkRadius; chunkY < chunkRadius; chunkY++)
+	{
+		for (int chunkX = -chunkRadius; chunkX < chunkRadius; chunkX++)
+		{
+			IntVec2 chunkCoords(chunkX, chunkY);
+			Chunk* chunk = new Chunk(world, chunkCoords);
+			chunk->Generateblocks();
+			world->m_initializedChunks[chunkCoords] = chunk;
+		}
+	}
+
+	//Scenario 1: activate the whole square and flood it
+	double startTime = 0.0;
+	ResetLightingCounters(world, startTime);
+	for (int chunkY = -chunkRadius; chunkY < chunkRadius; chunkY++)
+	{
+		for (int chunkX = -chunkRadius; chunkX < chunkRadius; chunkX++)
+		{
+			world->ActivateNewChunk(IntVec2(chunkX, chunkY));
+		}
+	}
+	world->ProcessDirtyLighting();
+	PrintLightingScenario(world, Stringf("activate%ix%i", 2 * chunkRadius, 2 * chunkRadius).c_str(), startTime);
+
+	//Scenario 2: dig a one block shaft from the surface down to bedrock
+	Chunk* shaftChunk = world->GetChunkForChunkCoordinates(IntVec2(0, 0));
+	int shaftTopZ = shaftChunk->GetHighestZNonAirBlock(8, 8);
+	ResetLightingCounters(world, startTime);
+	for (int localZ = shaftTopZ; localZ >= 1; localZ--)
+	{
+		DigBlockForBenchmark(world, shaftChunk, 8, 8, localZ);
+	}
+	PrintLightingScenario(world, "digShaft", startTime);
+
+	//Scenario 3: a stone shell with a dark cavity inside, then one glowstone placed in its middle
+	Chunk* caveChunk = world->GetChunkForChunkCoordinates(IntVec2(2, 2));
+	for (int localZ = 10; localZ <= 20; localZ++)
+	{
+		for (int localY = 2; localY <= 13; localY++)
+		{
+			for (int localX = 2; localX <= 13; localX++)
+			{
+				bool isShell = localZ == 10 || localZ == 20 || localY == 2 || localY == 13 || localX == 2 || localX == 13;
+				caveChunk->SetBlockType(localX, localY, localZ, isShell ? stone : air);
+				Block* block = caveChunk->GetBlockAtCoords(localX, localY, localZ);
+				block->SetIndoorLightInfluence(0);
+				block->SetOutdoorLightInfluence(0);
+				block->SetIsBlockSky(false);
+			}
+		}
+	}
+	ResetLightingCounters(world, startTime);
+	PlaceBlockForBenchmark(world, caveChunk, 7, 7, 15, glowstone);
+	PrintLightingScenario(world, "glowstoneInCave", startTime);
+
+	//Scenario 4: open a 6x6 pit to the sky, let it light up, then cap it one block per frame
+	Chunk* pitChunk = world->GetChunkForChunkCoordinates(IntVec2(-2, -2));
+	int pitTopZ = 0;
+	for (int localY = 5; localY <= 10; localY++)
+	{
+		for (int localX = 5; localX <= 10; localX++)
+		{
+			pitTopZ = std::max(pitTopZ, pitChunk->GetHighestZNonAirBlock(localX, localY));
+		}
+	}
+	int pitBottomZ = std::max(pitTopZ - 16, 1);
+	for (int localZ = pitTopZ; localZ >= pitBottomZ; localZ--)
+	{
+		for (int localY = 5; localY <= 10; localY++)
+		{
+			for (int localX = 5; localX <= 10; localX++)
+			{
+				DigBlockForBenchmark(world, pitChunk, localX, localY, localZ);
+			}
+		}
+	}
+	ResetLightingCounters(world, startTime);
+	for (int localY = 4; localY <= 11; localY++)
+	{
+		for (int localX = 4; localX <= 11; localX++)
+		{
+			PlaceBlockForBenchmark(world, pitChunk, localX, localY, pitTopZ, stone);
+		}
+	}
+	PrintLightingScenario(world, "capLitPit", startTime);
+
+	delete world;
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ChunkIOCounters
+{
+	int		m_numFileExistsChecks = 0;
+	int		m_numFileReads = 0;
+	int		m_numFileWrites = 0;
+	int		m_numFolderCreates = 0;
+	int64_t m_numBytesRead = 0;
+	int64_t m_numBytesWritten = 0;
+	double	m_startTime = 0.0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static ChunkIOCounters GetChunkIOCounters()
+{
+	ChunkIOCounters counters;
+	counters.m_numFileExistsChecks = Chunk::s_numFileExistsChecks;
+	counters.m_numFileReads = Chunk::s_numFileReads;
+	counters.m_numFileWrites = Chunk::s_numFileWrites;
+	counters.m_numFolderCreates = Chunk::s_numFolderCreates;
+	counters.m_numBytesRead = Chunk::s_numFileBytesRead;
+	counters.m_numBytesWritten = Chunk::s_numFileBytesWritten;
+	counters.m_startTime = GetCurrentTimeSeconds();
+	return counters;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void PrintChunkIOPhase(char const* phaseName, ChunkIOCounters const& start, int numChunks)
+{
+	ChunkIOCounters end = GetChunkIOCounters();
+	double elapsedSeconds = std::max(end.m_startTime - start.m_startTime, 1.0e-9);
+	int64_t numBytes = (end.m_numBytesRead - start.m_numBytesRead) + (end.m_numBytesWritten - start.m_numBytesWritten);
+	int numFileCalls = (end.m_numFileExistsChecks - start.m_numFileExistsChecks) + (end.m_numFileReads - start.m_numFileReads)
+		+ (end.m_numFileWrites - start.m_numFileWrites) + (end.m_numFolderCreates - start.m_numFolderCreates);
+
+	PrintToConsole(Stringf("BenchmarkChunkIO %-10s: %.1f MB/s, %.0f files/sec, %.2f ms total, file calls=%i (exists=%i read=%i write=%i mkdir=%i), %.1f calls/chunk",
+		phaseName, ((double)numBytes / (1024.0 * 1024.0)) / elapsedSeconds, (double)numChunks / elapsedSeconds, 1000.0 * elapsedSeconds, numFileCalls,
+		end.m_numFileExistsChecks - start.m_numFileExistsChecks, end.m_numFileReads - start.m_numFileReads,
+		end.m_numFileWrites - start.m_numFileWrites, end.m_numFolderCreates - start.m_numFolderCreates,
+		(double)numFileCalls / (double)std::max(numChunks, 1)));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static IntVec2 GetChunkIOBenchmarkCoords(int chunkIndex)
+{
+	constexpr int ROW_LENGTH = 128;
+	return IntVec2((chunkIndex % ROW_LENGTH) - ROW_LENGTH / 2, (chunkIndex / ROW_LENGTH) - ROW_LENGTH / 2);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void RunChunkDiskJobs(JobSystem* jobSystem, std::vector<Chunk*> const& sourceChunks, int numChunks, unsigned int worldSeed, bool isSaving)
+{
+	constexpr int BATCH_SIZE = 64;
+	std::vector<Chunk*> batchChunks;
+	for (int batchIndex = 0; batchIndex < BATCH_SIZE; batchIndex++)
+	{
+		batchChunks.push_back(new Chunk(IntVec2(0, 0), worldSeed));
+	}
+
+	for (int firstChunkIndex = 0; firstChunkIndex < numChunks; firstChunkIndex += BATCH_SIZE)
+	{
+		int numInBatch = std::min(BATCH_SIZE, numChunks - firstChunkIndex);
+		for (int batchIndex = 0; batchIndex < numInBatch; batchIndex++)
+		{
+			int chunkIndex = firstChunkIndex + batchIndex;
+			Chunk* chunk = batchChunks[batchIndex];
+			chunk->m_chunkCoords = GetChunkIOBenchmarkCoords(chunkIndex);
+			if (isSaving)
+			{
+				Chunk const* sourceChunk = sourceChunks[chunkIndex % sourceChunks.size()];
+				std::copy(sourceChunk->m_blocks, sourceChunk->m_blocks + CHUNK_BLOCKS_TOTAL, chunk->m_blocks);
+				jobSystem->QueueJob(new ChunkDiskSaveJob(chunk));
+			}
+			else
+			{
+				jobSystem->QueueJob(new ChunkDiskLoadJob(chunk));
+			}
+		}
+
+		int numRetrieved = 0;
+		while (numRetrieved < numInBatch)
+		{
+			Job* completedJob = jobSystem->RetrieveCompletedJobs();
+			if (completedJob == nullptr)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			delete completedJob;
+			numRetrieved++;
+		}
+	}
+
+	for (int batchIndex = 0; batchIndex < BATCH_SIZE; batchIndex++)
+	{
+		delete batchChunks[batchIndex];
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkChunkIO chunks=4000 seed=424242 threads=1 keep=false
+//	Writes and reads back chunk files under Saves/World_<seed> (a seed no real world uses by default), first by calling
+//	SaveBlockToFile/LoadBlocksFromFile directly and then through ChunkDiskSaveJob/ChunkDiskLoadJob on a private JobSystem
+//	with disk-only worker threads. Chunk contents are copied from 16 generated chunks, so the RLE sizes are realistic.
+//	"file calls" counts the engine file API calls made by the chunk code; each is at least one open/read/write/close
+//	sequence underneath, so run the headless build under strace -c for exact kernel syscall numbers.
+bool Benchmark::Event_BenchmarkChunkIO(EventArgs& args)
+{
+	constexpr int NUM_SOURCE_CHUNKS = 16;
+	int numChunks = std::max(args.GetValue("chunks", 4000), 1);
+	unsigned int worldSeed = static_cast<unsigned int>(args.GetValue("seed", 424242));
+	int numThreads = std::max(args.GetValue("threads", 1), 1);
+	bool keepFiles = args.GetValue("keep", false);
+
+	std::string folderPath = Stringf("Saves/World_%u", worldSeed);
+	std::error_code errorCode;
+	std::filesystem::remove_all(folderPath, errorCode);
+
+	std::vector<Chunk*> sourceChunks;
+	for (int sourceIndex = 0; sourceIndex < NUM_SOURCE_CHUNKS; sourceIndex++)
+	{
+		Chunk* sourceChunk = new Chunk(IntVec2(sourceIndex % 4, sourceIndex / 4), worldSeed);
+		sourceChunk->Generateblocks();
+		sourceChunks.push_back(sourceChunk);
+	}
+
+	Chunk* scratchChunk = new Chunk(IntVec2(0, 0), worldSeed);
+
+	ChunkIOCounters phaseStart = GetChunkIOCounters();
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		Chunk* sourceChunk = sourceChunks[chunkIndex % NUM_SOURCE_CHUNKS];
+		IntVec2 sourceCoords = sourceChunk->m_chunkCoords;
+		sourceChunk->m_chunkCoords = GetChunkIOBenchmarkCoords(chunkIndex);
+		sourceChunk->SaveBlockToFile();
+		sourceChunk->m_chunkCoords = sourceCoords;
+	}
+	PrintChunkIOPhase("save", phaseStart, numChunks);
+
+	int64_t bytesOnDisk = 0;
+	int numFilesOnDisk = 0;
+	for (std::filesystem::directory_iterator fileIt(folderPath, errorCode); !errorCode && fileIt != std::filesystem::directory_iterator(); fileIt.increment(errorCode))
+	{
+		bytesOnDisk += (int64_t)fileIt->file_size(errorCode);
+		numFilesOnDisk++;
+	}
+	PrintToConsole(Stringf("BenchmarkChunkIO on disk  : %i files, %.1f KB total, %.0f bytes/chunk (in memory %i bytes/chunk)",
+		numFilesOnDisk, (double)bytesOnDisk / 1024.0, (double)bytesOnDisk / (double)std::max(numFilesOnDisk, 1), (int)(sizeof(Block) * CHUNK_BLOCKS_TOTAL)));
+
+	phaseStart = GetChunkIOCounters();
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		scratchChunk->m_chunkCoords = GetChunkIOBenchmarkCoords(chunkIndex);
+		scratchChunk->LoadBlocksFromFile();
+	}
+	PrintChunkIOPhase("load", phaseStart, numChunks);
+
+	JobSystemConfig jobSystemConfig;
+	jobSystemConfig.m_numWorkerThreads = numThreads;
+	JobSystem* jobSystem = new JobSystem(jobSystemConfig);
+	jobSystem->Startup();
+	for (int jobThreadId = 0; jobThreadId < jobSystem->GetNumThreads(); jobThreadId++)
+	{
+		jobSystem->SetThreadJobType(jobThreadId, DISK_JOB_TYPE);
+	}
+
+	phaseStart = GetChunkIOCounters();
+	RunChunkDiskJobs(jobSystem, sourceChunks, numChunks, worldSeed, true);
+	PrintChunkIOPhase("saveJobs", phaseStart, numChunks);
+
+	phaseStart = GetChunkIOCounters();
+	RunChunkDiskJobs(jobSystem, sourceChunks, numChunks, worldSeed, false);
+	PrintChunkIOPhase("loadJobs", phaseStart, numChunks);
+
+	jobSystem->ShutDown();
+	delete jobSystem;
+
+	delete scratchChunk;
+	for (int sourceIndex = 0; sourceIndex < NUM_SOURCE_CHUNKS; sourceIndex++)
+	{
+		delete sourceChunks[sourceIndex];
+	}
+
+	if (!keepFiles)
+	{
+		std::filesystem::remove_all(folderPath, errorCode);
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkNoise seed=1 radius=3
+//	Computes the six terrain noise layers for the (2*radius+1)^2 chunks around the origin with scalar Compute2dPerlinNoise
+//	and with Compute2dPerlinNoiseTile, then reports the time for each, the largest difference between the two and how many
+//	columns end up with a different ground height. Run it after engine noise changes to confirm the tile kernel still matches.
+bool Benchmark::Event_BenchmarkNoise(EventArgs& args)
+{
+	unsigned int worldSeed = static_cast<unsigned int>(args.GetValue("seed", 1));
+	int gridRadius = std::max(args.GetValue("radius", 3), 0);
+
+	constexpr int NUM_LAYERS = 6;
+	float const layerScales[NUM_LAYERS] = { 800.f, 800.f, 30.f, 800.f, 400.f, 200.f };
+	unsigned int const layerOctaves[NUM_LAYERS] = { 9, 5, 9, 7, 5, 7 };
+	unsigned int const layerSeeds[NUM_LAYERS] = { worldSeed + 1, worldSeed + 2, worldSeed + 9, worldSeed + 3, worldSeed + 4, worldSeed };
+
+	float scalarNoise[NUM_LAYERS][CHUNK_BLOCKS_PER_LAYER];
+	float tileNoise[NUM_LAYERS][CHUNK_BLOCKS_PER_LAYER];
+	NoiseTileLayer layers[NUM_LAYERS];
+	for (int layerIndex = 0; layerIndex < NUM_LAYERS; layerIndex++)
+	{
+		layers[layerIndex].m_scale = layerScales[layerIndex];
+		layers[layerIndex].m_numOctaves = layerOctaves[layerIndex];
+		layers[layerIndex].m_seed = layerSeeds[layerIndex];
+		layers[layerIndex].m_out_values = tileNoise[layerIndex];
+	}
+
+	double scalarSeconds = 0.0;
+	double tileSeconds = 0.0;
+	float maxDifference = 0.f;
+	int numChunks = 0;
+	int numHeightMismatches = 0;
+	for (int chunkY = -gridRadius; chunkY <= gridRadius; chunkY++)
+	{
+		for (int chunkX = -gridRadius; chunkX <= gridRadius; chunkX++)
+		{
+			float chunkMinsX = (float)(chunkX * CHUNK_SIZE_X);
+			float chunkMinsY = (float)(chunkY * CHUNK_SIZE_Y);
+
+			double startTime = GetCurrentTimeSeconds();
+			for (int layerIndex = 0; layerIndex < NUM_LAYERS; layerIndex++)
+			{
+				for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; columnIndex++)
+				{
+					float globalX = chunkMinsX + float(columnIndex & CHUNK_MAX_X);
+					float globalY = chunkMinsY + float(columnIndex >> CHUNK_BITS_X);
+					scalarNoise[layerIndex][columnIndex] = Compute2dPerlinNoise(globalX, globalY, layerScales[layerIndex], layerOctaves[layerIndex], 0.5f, 2.f, true, layerSeeds[layerIndex]);
+				}
+			}
+			double tileStartTime = GetCurrentTimeSeconds();
+			Compute2dPerlinNoiseTile(chunkMinsX, chunkMinsY, layers, NUM_LAYERS);
+			double endTime = GetCurrentTimeSeconds();
+
+			scalarSeconds += tileStartTime - startTime;
+			tileSeconds += endTime - tileStartTime;
+			numChunks++;
+
+			for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; columnIndex++)
+			{
+				for (int layerIndex = 0; layerIndex < NUM_LAYERS; layerIndex++)
+				{
+					maxDifference = std::max(maxDifference, fabsf(scalarNoise[layerIndex][columnIndex] - tileNoise[layerIndex][columnIndex]));
+				}
+				int scalarHeightZ = ColumnCache::ComputeGroundHeightZFromNoise(scalarNoise[3][columnIndex], scalarNoise[4][columnIndex], scalarNoise[5][columnIndex]);
+				int tileHeightZ = ColumnCache::ComputeGroundHeightZFromNoise(tileNoise[3][columnIndex], tileNoise[4][columnIndex], tileNoise[5][columnIndex]);
+				if (scalarHeightZ != tileHeightZ)
+				{
+					numHeightMismatches++;
+				}
+			}
+		}
+	}
+
+	if (tileSeconds <= 0.0)
+	{
+		tileSeconds = 1e-9;
+	}
+	PrintToConsole(Stringf("BenchmarkNoise seed=%u: %i chunks x %i layers, scalar=%.2fms tile=%.2fms (%.1fx), max difference=%g, ground height mismatches=%i, column cache uses %s",
+		worldSeed, numChunks, NUM_LAYERS, 1000.0 * scalarSeconds, 1000.0 * tileSeconds, scalarSeconds / tileSeconds, maxDifference, numHeightMismatches,
+		ColumnCache::DoNoiseTilesMatchScalarNoise() ? "tiles" : "scalar noise"),
+		numHeightMismatches == 0 ? Rgba8(0, 255, 255, 255) : Rgba8(255, 255, 0, 255));
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkClimateLattice seed=1 radius=3 maxError=0.01
+//	Builds the column data of the (2*radius+1)^2 chunks around the origin per column and then with each climate lattice
+//	spacing, all with the scalar noise. Per spacing it prints the time, the noise evaluations per chunk, the largest temperature/humidity error and how
+//	many columns changed ground height, and finally the largest spacing whose climate error stays within maxError.
+bool Benchmark::Event_BenchmarkClimateLattice(EventArgs& args)
+{
+	unsigned int worldSeed = static_cast<unsigned int>(args.GetValue("seed", 1));
+	int gridRadius = std::max(args.GetValue("radius", 3), 0);
+	float maxAllowedError = args.GetValue("maxError", 0.01f);
+
+	std::vector<IntVec2> chunkCoordsList;
+	for (int chunkY = -gridRadius; chunkY <= gridRadius; chunkY++)
+	{
+		for (int chunkX = -gridRadius; chunkX <= gridRadius; chunkX++)
+		{
+			chunkCoordsList.push_back(IntVec2(chunkX, chunkY));
+		}
+	}
+	int numChunks = (int)chunkCoordsList.size();
+
+	//Lattice points are always sampled with the scalar noise, so the reference is too: the error reported is then only
+	//the interpolation's, not the tile kernel's rounding or drift on top of it
+	ColumnCacheConfig referenceConfig;
+	referenceConfig.m_worldSeed = worldSeed;
+	referenceConfig.m_useNoiseTiles = false;
+	std::vector<ChunkColumns> referenceColumns(numChunks);
+	double referenceStartTime = GetCurrentTimeSeconds();
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		ColumnCache::ComputeChunkColumns(chunkCoordsList[chunkIndex], referenceConfig, referenceColumns[chunkIndex]);
+	}
+	double referenceSeconds = GetCurrentTimeSeconds() - referenceStartTime;
+	PrintToConsole(Stringf("BenchmarkClimateLattice seed=%u per column: %i chunks, %.2fms, %i climate noise evaluations per chunk",
+		worldSeed, numChunks, 1000.0 * referenceSeconds, 3 * CHUNK_BLOCKS_PER_LAYER), Rgba8(0, 255, 255, 255));
+
+	int bestLatticeSpacing = 0;
+	ChunkColumns latticeColumns;
+	for (int latticeSpacing = 2; latticeSpacing <= std::min(CHUNK_SIZE_X, CHUNK_SIZE_Y); latticeSpacing *= 2)
+	{
+		ColumnCacheConfig latticeConfig = referenceConfig;
+		latticeConfig.m_climateLatticeSpacing = latticeSpacing;
+
+		double latticeSeconds = 0.0;
+		float maxClimateError = 0.f;
+		int maxHeightError = 0;
+		int numHeightMismatches = 0;
+		for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+		{
+			double startTime = GetCurrentTimeSeconds();
+			ColumnCache::ComputeChunkColumns(chunkCoordsList[chunkIndex], latticeConfig, latticeColumns);
+			latticeSeconds += GetCurrentTimeSeconds() - startTime;
+
+			for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; columnIndex++)
+			{
+				ColumnData const& reference = referenceColumns[chunkIndex].m_columns[columnIndex];
+				ColumnData const& lattice = latticeColumns.m_columns[columnIndex];
+				maxClimateError = std::max(maxClimateError, fabsf(reference.m_temperature - lattice.m_temperature));
+				maxClimateError = std::max(maxClimateError, fabsf(reference.m_humidity - lattice.m_humidity));
+				int heightError = abs(reference.m_groundHeightZ - lattice.m_groundHeightZ);
+				maxHeightError = std::max(maxHeightError, heightError);
+				numHeightMismatches += (heightError != 0) ? 1 : 0;
+			}
+		}
+
+		bool isWithinBound = maxClimateError <= maxAllowedError;
+		if (isWithinBound)
+		{
+			bestLatticeSpacing = latticeSpacing;
+		}
+		int numLatticePoints = (CHUNK_SIZE_X / latticeSpacing + 1) * (CHUNK_SIZE_Y / latticeSpacing + 1);
+		PrintToConsole(Stringf("  spacing=%2i: %.2fms, %i climate noise evaluations per chunk, max climate error=%.5f, ground height mismatches=%i (max %i blocks)%s",
+			latticeSpacing, 1000.0 * latticeSeconds, 3 * numLatticePoints, maxClimateError, numHeightMismatches, maxHeightError, isWithinBound ? "" : " OVER BOUND"),
+			isWithinBound ? Rgba8(0, 255, 255, 255) : Rgba8(255, 255, 0, 255));
+	}
+
+	PrintToConsole(Stringf("BenchmarkClimateLattice: largest spacing within maxError=%g is %i (GameConfig climateLatticeSpacing, 0 = per column)", maxAllowedError, bestLatticeSpacing),
+		Rgba8(0, 255, 255, 255));
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkCaveStarts seed=1 radius=1 checkRadius=40
+//	Finds the worm cave starts of GenerateCaves for the (2*radius+1)^2 chunks around the origin with the original std::map
+//	noise and window scans, then with the flat noise field and sliding window maxima. Prints both times and how many chunks
+//	found a different list of starts, which must be zero.
+bool Benchmark::Event_BenchmarkCaveStarts(EventArgs& args)
+{
+	unsigned int worldSeed = static_cast<unsigned int>(args.GetValue("seed", 1));
+	int gridRadius = std::max(args.GetValue("radius", 1), 0);
+	int caveCheckRadius = std::max(args.GetValue("checkRadius", 40), 1);
+
+	double referenceSeconds = 0.0;
+	double flatSeconds = 0.0;
+	int numChunks = 0;
+	int numCaveStarts = 0;
+	int numMismatchedChunks = 0;
+	std::vector<IntVec2> referenceStarts;
+	std::vector<IntVec2> flatStarts;
+	for (int chunkY = -gridRadius; chunkY <= gridRadius; chunkY++)
+	{
+		for (int chunkX = -gridRadius; chunkX <= gridRadius; chunkX++)
+		{
+			Chunk* chunk = new Chunk(IntVec2(chunkX, chunkY), worldSeed);
+			chunk->m_caveCheckRadius = caveCheckRadius;
+			referenceStarts.clear();
+			flatStarts.clear();
+
+			double startTime = GetCurrentTimeSeconds();
+			chunk->FindCaveStartMaximaReference(referenceStarts);
+			double flatStartTime = GetCurrentTimeSeconds();
+			chunk->FindCaveStartMaxima(flatStarts);
+			double endTime = GetCurrentTimeSeconds();
+			delete chunk;
+
+			referenceSeconds += flatStartTime - startTime;
+			flatSeconds += endTime - flatStartTime;
+			numChunks++;
+			numCaveStarts += (int)referenceStarts.size();
+			if (referenceStarts != flatStarts)
+			{
+				numMismatchedChunks++;
+			}
+		}
+	}
+
+	if (flatSeconds <= 0.0)
+	{
+		flatSeconds = 1e-9;
+	}
+	PrintToConsole(Stringf("BenchmarkCaveStarts seed=%u checkRadius=%i: %i chunks, %i cave starts, map=%.2fms flat=%.2fms (%.1fx), mismatched chunks=%i",
+		worldSeed, caveCheckRadius, numChunks, numCaveStarts, 1000.0 * referenceSeconds, 1000.0 * flatSeconds, referenceSeconds / flatSeconds, numMismatchedChunks),
+		numMismatchedChunks == 0 ? Rgba8(0, 255, 255, 255) : Rgba8(255, 255, 0, 255));
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void PrintOreRun(char const* pathName, double seconds, int64_t const oreCounts[NUM_ORE_TYPES], int64_t numBlocks)
+{
+	double blocks = (double)std::max(numBlocks, (int64_t)1);
+	PrintToConsole(Stringf("  %-7s %.2fms (%.1fns/block), coal=%.3f%% iron=%.3f%% gold=%.3f%% diamond=%.3f%%",
+		pathName, 1000.0 * seconds, 1e9 * seconds / blocks,
+		100.0 * (double)oreCounts[ORE_COAL] / blocks, 100.0 * (double)oreCounts[ORE_IRON] / blocks,
+		100.0 * (double)oreCounts[ORE_GOLD] / blocks, 100.0 * (double)oreCounts[ORE_DIAMOND] / blocks), Rgba8(0, 255, 255, 255));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkOres seed=1 radius=3
+//	Picks ore types for the layers below sea level of the (2*radius+1)^2 chunks around the origin three ways: the original
+//	chained RollRandomChance calls, the per-block hashed field and the clustered vein lattices. Prints the time and ore mix
+//	of each; the vein rates are per block of the whole band, so the deep-only ores read lower than within their depths.
+bool Benchmark::Event_BenchmarkOres(EventArgs& args)
+{
+	unsigned int worldSeed = static_cast<unsigned int>(args.GetValue("seed", 1));
+	int gridRadius = std::max(args.GetValue("radius", 3), 0);
+	unsigned int oreSeed = worldSeed + 13;
+
+	int64_t rngCounts[NUM_ORE_TYPES] = {};
+	int64_t hashCounts[NUM_ORE_TYPES] = {};
+	int64_t veinCounts[NUM_ORE_TYPES] = {};
+	double rngSeconds = 0.0;
+	double hashSeconds = 0.0;
+	double veinSeconds = 0.0;
+	int64_t numBlocks = 0;
+	uint8_t oreTypes[CHUNK_BLOCKS_PER_LAYER];
+	for (int chunkY = -gridRadius; chunkY <= gridRadius; chunkY++)
+	{
+		for (int chunkX = -gridRadius; chunkX <= gridRadius; chunkX++)
+		{
+			int chunkMinsX = chunkX * CHUNK_SIZE_X;
+			int chunkMinsY = chunkY * CHUNK_SIZE_Y;
+
+			double startTime = GetCurrentTimeSeconds();
+			RandomNumberGenerator rng(worldSeed);
+			for (int blockIndex = 0; blockIndex < SEA_LEVEL * CHUNK_BLOCKS_PER_LAYER; blockIndex++)
+			{
+				OreType oreType = ORE_NONE;
+				if (rng.RollRandomChance(0.05f))
+					oreType = ORE_COAL;
+				if (rng.RollRandomChance(0.02f))
+					oreType = ORE_IRON;
+				if (rng.RollRandomChance(0.005f))
+					oreType = ORE_GOLD;
+				if (rng.RollRandomChance(0.001f))
+					oreType = ORE_DIAMOND;
+				rngCounts[oreType]++;
+			}
+
+			double hashStartTime = GetCurrentTimeSeconds();
+			for (int localZ = 0; localZ < SEA_LEVEL; localZ++)
+			{
+				ComputeOreLayer(chunkMinsX, chunkMinsY, localZ, oreSeed, oreTypes);
+				for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; columnIndex++)
+				{
+					hashCounts[oreTypes[columnIndex]]++;
+				}
+			}
+
+			double veinStartTime = GetCurrentTimeSeconds();
+			OreVeinField oreVeins(chunkMinsX, chunkMinsY, oreSeed);
+			for (int localZ = 0; localZ < SEA_LEVEL; localZ++)
+			{
+				oreVeins.ComputeLayer(localZ, oreTypes);
+				for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; columnIndex++)
+				{
+					veinCounts[oreTypes[columnIndex]]++;
+				}
+			}
+			double endTime = GetCurrentTimeSeconds();
+
+			rngSeconds += hashStartTime - startTime;
+			hashSeconds += veinStartTime - hashStartTime;
+			veinSeconds += endTime - veinStartTime;
+			numBlocks += SEA_LEVEL * CHUNK_BLOCKS_PER_LAYER;
+		}
+	}
+
+	PrintToConsole(Stringf("BenchmarkOres seed=%u: %i chunks, %lld blocks below sea level", worldSeed, (2 * gridRadius + 1) * (2 * gridRadius + 1), numBlocks), Rgba8(0, 255, 255, 255));
+	PrintOreRun("rng", rngSeconds, rngCounts, numBlocks);
+	PrintOreRun("hashed", hashSeconds, hashCounts, numBlocks);
+	PrintOreRun("veins", veinSeconds, veinCounts, numBlocks);
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// BenchmarkSpawn seeds=1,2,3 threads=<hardware threads> bands=1,2,4,8
+//	Generates the 3x3 chunks around the origin that the first frame waits for, splitting each chunk's rows into the given
+//	number of band jobs on a private JobSystem, and reports the wall time until the last chunk completes. bands=1 is the
+//	one-job-per-chunk path; with 9 chunks and more threads than that, only the split paths can keep every worker busy.
+bool Benchmark::Event_BenchmarkSpawn(EventArgs& args)
+{
+	std::vector<int> seeds = ParseIntList(args.GetValue("seeds", std::string("1,2,3")));
+	int numThreads = std::max(args.GetValue("threads", (int)std::thread::hardware_concurrency()), 1);
+	std::vector<int> bandCounts = ParseIntList(args.GetValue("bands", std::string("1,2,4,8")));
+
+	JobSystemConfig jobSystemConfig;
+	jobSystemConfig.m_numWorkerThreads = numThreads;
+	JobSystem* jobSystem = new JobSystem(jobSystemConfig);
+	jobSystem->Startup();
+	for (int jobThreadId = 0; jobThreadId < jobSystem->GetNumThreads(); jobThreadId++)
+	{
+		jobSystem->SetThreadJobType(jobThreadId, CHUNK_GENERATION_JOB_TYPE);
+	}
+
+	PrintToConsole(Stringf("BenchmarkSpawn: 9 chunks per run, %i threads", numThreads), Rgba8(0, 255, 255, 255));
+	for (int seedIndex = 0; seedIndex < (int)seeds.size(); seedIndex++)
+	{
+		unsigned int worldSeed = static_cast<unsigned int>(seeds[seedIndex]);
+		double singleBandSeconds = 0.0;
+		for (int bandCountIndex = 0; bandCountIndex < (int)bandCounts.size(); bandCountIndex++)
+		{
+			int numBands = std::max(1, std::min(bandCounts[bandCountIndex], CHUNK_SIZE_Y));
+
+			ColumnCacheConfig columnConfig;
+			columnConfig.m_worldSeed = worldSeed;
+			ColumnCache* columnCache = new ColumnCache(columnConfig);
+			CaveCache* caveCache = new CaveCache(Chunk::GetWorldCaveSeedForWorldSeed(worldSeed));
+
+			std::vector<Chunk*> chunks;
+			for (int chunkY = -1; chunkY <= 1; chunkY++)
+			{
+				for (int chunkX = -1; chunkX <= 1; chunkX++)
+				{
+					Chunk* chunk = new Chunk(IntVec2(chunkX, chunkY), worldSeed);
+					chunk->m_columnCache = columnCache;
+					chunk->m_caveCache = caveCache;
+					chunks.push_back(chunk);
+				}
+			}
+
+			double runStartTime = GetCurrentTimeSeconds();
+			for (int chunkIndex = 0; chunkIndex < (int)chunks.size(); chunkIndex++)
+			{
+				if (numBands > 1)
+				{
+					chunks[chunkIndex]->PrepareGenerationBands(numBands);
+				}
+				for (int bandIndex = 0; bandIndex < numBands; bandIndex++)
+				{
+					jobSystem->QueueJob(new BenchmarkSpawnBandJob(chunks[chunkIndex], bandIndex, numBands));
+				}
+			}
+
+			int numJobsLeft = (int)chunks.size() * numBands;
+			int numChunksCompleted = 0;
+			double runSeconds = 0.0;
+			while (numJobsLeft > 0)
+			{
+				Job* completedJob = jobSystem->RetrieveCompletedJobs();
+				if (completedJob == nullptr)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				BenchmarkSpawnBandJob* bandJob = (BenchmarkSpawnBandJob*)completedJob;
+				if (bandJob->m_completesChunk)
+				{
+					numChunksCompleted++;
+					if (numChunksCompleted == (int)chunks.size())
+					{
+						runSeconds = GetCurrentTimeSeconds() - runStartTime;
+					}
+				}
+				numJobsLeft--;
+				delete completedJob;
+			}
+
+			for (int chunkIndex = 0; chunkIndex < (int)chunks.size(); chunkIndex++)
+			{
+				delete chunks[chunkIndex];
+			}
+			delete columnCache;
+			delete caveCache;
+
+			if (numBands == 1)
+			{
+				singleBandSeconds = runSeconds;
+			}
+			std::string speedup = (singleBandSeconds > 0.0) ? Stringf(", %.2fx vs bands=1", singleBandSeconds / runSeconds) : std::string();
+			PrintToConsole(Stringf("seed=%u bands=%i: spawn chunks ready in %.2fms%s", worldSeed, numBands, 1000.0 * runSeconds, speedup.c_str()), Rgba8(0, 255, 255, 255));
+		}
+	}
+
+	jobSystem->ShutDown();
+	delete jobSystem;
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::vector<int> Benchmark::ParseIntList(std::string const& commaSeparatedList)
+{
+	std::vector<int> values;
+	size_t startIndex = 0;
+	while (startIndex <= commaSeparatedList.size())
+	{
+		size_t commaIndex = commaSeparatedList.find(',', startIndex);
+		if (commaIndex == std::string::npos)
+		{
+			commaIndex = commaSeparatedList.size();
+		}
+
+		std::string token = commaSeparatedList.substr(startIndex, commaIndex - startIndex);
+		if (!token.empty())
+		{
+			values.push_back(atoi(token.c_str()));
+		}
+		startIndex = commaIndex + 1;
+	}
+	return values;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+double Benchmark::GetPercentile(std::vector<double> const& sortedValues, float percentile)
+{
+	if (sortedValues.empty())
+	{
+		return 0.0;
+	}
+
+	//Nearest-rank percentile, values must already be sorted ascending
+	int rank = static_cast<int>(ceilf(percentile * static_cast<float>(sortedValues.size())));
+	int valueIndex = std::min(std::max(rank - 1, 0), (int)sortedValues.size() - 1);
+	return sortedValues[valueIndex];
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,27 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dev console / headless commands that measure the simulation core in isolation.
+// Every benchmark prints one line per configuration so runs can be diffed against each other.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class Benchmark
+{
+public:
+	static void			RegisterCommands();
+	static bool			Event_BenchmarkGeneration(EventArgs& args);
+	static bool			Event_BenchmarkMesh(EventArgs& args);
+	static bool			Event_BenchmarkLighting(EventArgs& args);
+	static bool			Event_BenchmarkChunkIO(EventArgs& args);
+	static bool			Event_BenchmarkNoise(EventArgs& args);
+	static bool			Event_BenchmarkClimateLattice(EventArgs& args);
+	static bool			Event_BenchmarkCaveStarts(EventArgs& args);
+	static bool			Event_BenchmarkOres(EventArgs& args);
+	static bool			Event_BenchmarkSpawn(EventArgs& args);
+
+	static std::vector<int>	ParseIntList(std::string const& commaSeparatedList);
+	static double		GetPercentile(std::vector<double> const& sortedValues, float percentile);
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
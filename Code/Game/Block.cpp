@@ -10,11 +10,6 @@ Block::Block()
 Block::~Block()
 {
 
-}
-//--------------------------------------------------------------------------------------------------------------------------------------------------------
-void Block::SetTypeID(BlockDefID newType)
-{
-	m_blockDefID = newType;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 BlockDef const& Block::GetType()
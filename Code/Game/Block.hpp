@@ -11,7 +11,7 @@ public:
 	Block();
 	~Block();
 
-	void			  SetTypeID(BlockDefID newType);
+	void			  SetTypeID(BlockDefID newType) { m_blockDefID = newType; };
 	BlockDefID		  GetTypeID() const { return m_blockDefID; };
 	BlockDef const&	  GetType();
 	uint8_t			  GetIndoorLightInfluence() const;
@@ -1,6 +1,9 @@
 #include "Game/BlockDef.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "GameCommon.hpp"
+#if !defined(GAME_HEADLESS)
+#include "Engine/Renderer/SpriteSheet.hpp"
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 std::vector<BlockDef> BlockDef::s_blockDefs;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -101,17 +104,28 @@ void BlockDef::CreateNewBlockDef(std::string const& name, bool isVisible, bool i
 	def.m_isOpaque = isOpaque;
 	def.m_indoorLightInfluence = indoorLightInfluence;
 
-	int const SPRITES_PER_ROW = TERRAIN_SPRITE_LAYOUT.x;
-
-	int topSpriteIndex = topSpriteCoords.x + (topSpriteCoords.y * SPRITES_PER_ROW);
-	def.m_uvsTop = g_terrainSpriteSheet->GetSpriteDef(topSpriteIndex).GetUVs();
-
-	int sideSpriteIndex = sideSpriteCoords.x + (sideSpriteCoords.y * SPRITES_PER_ROW);
-	def.m_uvsSides = g_terrainSpriteSheet->GetSpriteDef(sideSpriteIndex).GetUVs();
-
-	int bottomSpriteIndex = bottomSpriteCoords.x + (bottomSpriteCoords.y * SPRITES_PER_ROW);
-	def.m_uvsBottom = g_terrainSpriteSheet->GetSpriteDef(bottomSpriteIndex).GetUVs();
+	def.m_uvsTop = GetUVsForSpriteCoords(topSpriteCoords);
+	def.m_uvsSides = GetUVsForSpriteCoords(sideSpriteCoords);
+	def.m_uvsBottom = GetUVsForSpriteCoords(bottomSpriteCoords);
 
 	s_blockDefs.push_back(def);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+AABB2 BlockDef::GetUVsForSpriteCoords(IntVec2 const& spriteCoords)
+{
+	int const SPRITES_PER_ROW = TERRAIN_SPRITE_LAYOUT.x;
+
+#if !defined(GAME_HEADLESS)
+	int spriteIndex = spriteCoords.x + (spriteCoords.y * SPRITES_PER_ROW);
+	return g_terrainSpriteSheet->GetSpriteDef(spriteIndex).GetUVs();
+#else
+	//No sprite sheet without a renderer, so lay out the same grid by hand (row 0 is the top of the texture)
+	int const SPRITES_PER_COLUMN = TERRAIN_SPRITE_LAYOUT.y;
+	float uMin = float(spriteCoords.x) / float(SPRITES_PER_ROW);
+	float uMax = float(spriteCoords.x + 1) / float(SPRITES_PER_ROW);
+	float vMin = 1.f - (float(spriteCoords.y + 1) / float(SPRITES_PER_COLUMN));
+	float vMax = 1.f - (float(spriteCoords.y) / float(SPRITES_PER_COLUMN));
+	return AABB2(Vec2(uMin, vMin), Vec2(uMax, vMax));
+#endif
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
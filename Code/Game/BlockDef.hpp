@@ -2,10 +2,11 @@
 #include "Engine/Core/vertexUtils.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVec2.hpp"
 #include "Engine/Core/StringUtils.hpp"
-#include "Engine/Renderer/Texture.hpp"
-#include "Engine/Renderer/SpriteSheet.hpp"
 
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class Texture;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 typedef uint8_t BlockDefID;
 constexpr BlockDefID BLOCKDEF_ID_INVALID = BlockDefID(-1);
@@ -26,6 +27,7 @@ public:
 protected:
 	static void				CreateNewBlockDef(std::string const& name, bool isVisible, bool isSolid, bool isOpaque, uint8_t indoorLightInfluence, IntVec2 topSpriteCoords,
 							IntVec2 sideSpriteCoords, IntVec2 bottomSpriteCoords);
+	static AABB2			GetUVsForSpriteCoords(IntVec2 const& spriteCoords);
 public:
 	static std::vector<BlockDef> s_blockDefs;
 	static Texture*				 s_blockSpriteTexture;
@@ -1,5 +1,6 @@
 #include "Game/BlockIterator.hpp"
 #include "Engine/Math/AABB3.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 BlockIterator::BlockIterator()
@@ -1,4 +1,6 @@
 #include "Game/BlockTemplate.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 std::vector<BlockTemplate*> BlockTemplate::s_blockTemplates;
@@ -18,6 +20,79 @@ BlockTemplate::BlockTemplate()
 BlockTemplate::BlockTemplate(char const* name, std::vector<BlockTemplateEntry>& blockTemplateEntries)
 	:m_templateName(name), m_blockTemplateEntries(blockTemplateEntries)
 {
+	CompileRuns();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void BlockTemplate::CompileRuns()
+{
+	m_runs.clear();
+	m_layerFirstRuns.clear();
+	m_boundsMins = IntVec3::ZERO;
+	m_boundsMaxs = IntVec3::ZERO;
+	if (m_blockTemplateEntries.empty())
+	{
+		m_layerFirstRuns.push_back(0);
+		return;
+	}
+
+	m_boundsMins = m_blockTemplateEntries[0].m_offset;
+	m_boundsMaxs = m_blockTemplateEntries[0].m_offset;
+	for (int entryIndex = 1; entryIndex < (int)m_blockTemplateEntries.size(); entryIndex++)
+	{
+		IntVec3 const& offset = m_blockTemplateEntries[entryIndex].m_offset;
+		m_boundsMins = IntVec3(std::min(m_boundsMins.x, offset.x), std::min(m_boundsMins.y, offset.y), std::min(m_boundsMins.z, offset.z));
+		m_boundsMaxs = IntVec3(std::max(m_boundsMaxs.x, offset.x), std::max(m_boundsMaxs.y, offset.y), std::max(m_boundsMaxs.z, offset.z));
+	}
+
+	//Resolve the entries into a dense box laid out like a chunk (x fastest), BLOCKDEF_ID_INVALID where nothing is placed
+	int sizeX = m_boundsMaxs.x - m_boundsMins.x + 1;
+	int sizeY = m_boundsMaxs.y - m_boundsMins.y + 1;
+	int sizeZ = m_boundsMaxs.z - m_boundsMins.z + 1;
+	std::vector<BlockDefID> boxBlocks(sizeX * sizeY * sizeZ, BLOCKDEF_ID_INVALID);
+	for (int entryIndex = 0; entryIndex < (int)m_blockTemplateEntries.size(); entryIndex++)
+	{
+		BlockTemplateEntry const& entry = m_blockTemplateEntries[entryIndex];
+		IntVec3 boxCoords = entry.m_offset - m_boundsMins;
+		boxBlocks[boxCoords.x + (boxCoords.y * sizeX) + (boxCoords.z * sizeX * sizeY)] = entry.m_blockType;
+	}
+
+	for (int boxZ = 0; boxZ < sizeZ; boxZ++)
+	{
+		m_layerFirstRuns.push_back((int)m_runs.size());
+		for (int boxY = 0; boxY < sizeY; boxY++)
+		{
+			BlockDefID const* rowBlocks = &boxBlocks[(boxY * sizeX) + (boxZ * sizeX * sizeY)];
+			int boxX = 0;
+			while (boxX < sizeX)
+			{
+				int runEndX = boxX + 1;
+				while (runEndX < sizeX && rowBlocks[runEndX] == rowBlocks[boxX])
+				{
+					runEndX++;
+				}
+
+				if (rowBlocks[boxX] != BLOCKDEF_ID_INVALID)
+				{
+					BlockTemplateRun run;
+					run.m_start = m_boundsMins + IntVec3(boxX, boxY, boxZ);
+					run.m_length = runEndX - boxX;
+					run.m_blockType = rowBlocks[boxX];
+					m_runs.push_back(run);
+				}
+				boxX = runEndX;
+			}
+		}
+	}
+	m_layerFirstRuns.push_back((int)m_runs.size());
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Index of the first run at offsetZ, clamped to the template's layers, so the runs of offsets [a, b) are [first(a), first(b))
+int BlockTemplate::GetFirstRunInLayer(int offsetZ) const
+{
+	int layerIndex = offsetZ - m_boundsMins.z;
+	layerIndex = std::max(layerIndex, 0);
+	layerIndex = std::min(layerIndex, (int)m_layerFirstRuns.size() - 1);
+	return m_layerFirstRuns[layerIndex];
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void BlockTemplate::InitializeBlockTemplateDefinitions()
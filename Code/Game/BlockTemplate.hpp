@@ -14,6 +14,18 @@ public:
 	IntVec3    m_offset;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Neighboring blocks of one template along +x that share a y, a z and a block type
+struct BlockTemplateRun
+{
+	IntVec3		m_start;			//offset of the run's lowest-x block from the template origin
+	int			m_length = 0;
+	BlockDefID	m_blockType = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// The entry list is compiled once when the template is made: entries are resolved into a dense box over their bounds
+// (a later entry at the same offset wins, as when entries were written one by one) and read back out as x-runs ordered
+// by z, then y. Stamping clips the bounds against a chunk once and copies whole runs.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 class BlockTemplate 
 {
 public:
@@ -23,9 +35,19 @@ public:
 	static void					InitializeBlockTemplateDefinitions();
 	static void					DestroyBlockTemplateDefinitions();
 	static BlockTemplate const* GetBlockTemplateByName(char const* name);
-	
+
+	int							GetFirstRunInLayer(int offsetZ) const;
+
+private:
+	void						CompileRuns();
+
+public:
 	std::vector<BlockTemplateEntry>     m_blockTemplateEntries;
 	std::string						    m_templateName;
+	IntVec3								m_boundsMins;			//smallest entry offset on each axis
+	IntVec3								m_boundsMaxs;			//largest entry offset on each axis
+	std::vector<BlockTemplateRun>		m_runs;
+	std::vector<int>					m_layerFirstRuns;		//first run of each z from m_boundsMins.z, then the run count
 	static std::vector<BlockTemplate*>  s_blockTemplates;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "Game/CaveCache.hpp"
+#include "Game/GameCommon.hpp"
+#include "ThirdParty/Squirrel/SmoothNoise.hpp"
+#include "ThirdParty/Squirrel/RawNoise.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+//Cave generation constants
+constexpr float CHANCE_FOR_CAVE_TO_START_IN_A_CHUNK = 0.01f;
+constexpr float CAVE_STEP_LENGTH = 10.f;
+constexpr float CAVE_MAX_TURN_DEGREES = 30.f;
+constexpr int   CAVE_NUM_CRAWL_STEPS = 25;
+constexpr float CAVE_MAX_DISTANCE_BLOCKS = CAVE_STEP_LENGTH * float(CAVE_NUM_CRAWL_STEPS) + CaveCache::CAVE_RADIUS;
+
+//Calculate how big of a search area we will need to check chunks in order to detect for caves
+constexpr int CHUNK_WIDTH = (CHUNK_SIZE_X < CHUNK_SIZE_Y ? CHUNK_SIZE_X : CHUNK_SIZE_Y);
+constexpr int CAVE_SEARCH_RADIUS = 1 + int(CAVE_MAX_DISTANCE_BLOCKS / CHUNK_WIDTH);
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+CaveCache::CaveCache(unsigned int worldCaveSeed, int maxCachedCaves)
+	:m_worldCaveSeed(worldCaveSeed)
+	,m_caves(maxCachedCaves, MEMORY_CAVE_CACHE, PERF_COUNTER_CAVE_CACHE_HITS, PERF_COUNTER_CAVE_CACHE_MISSES, &CaveCache::GetCaveBytes)
+{
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::shared_ptr<CaveInfo const> CaveCache::GetCave(IntVec2 const& startChunkCoords)
+{
+	std::shared_ptr<CaveInfo const> cachedCave = m_caves.Find(startChunkCoords);
+	if (cachedCave != nullptr)
+	{
+		return cachedCave;
+	}
+
+	std::shared_ptr<CaveInfo> cave = std::make_shared<CaveInfo>(startChunkCoords);
+	ComputeCave(m_worldCaveSeed, *cave);
+	return m_caves.Insert(startChunkCoords, cave);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int CaveCache::GetNumCachedCaves()
+{
+	return m_caves.GetNumEntries();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+size_t CaveCache::GetCaveBytes(CaveInfo const& cave)
+{
+	return sizeof(CaveInfo) + cave.m_caveNodePositions.capacity() * sizeof(IntVec3) + cave.m_segmentsByChunk.capacity() * sizeof(CaveSegment);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void CaveCache::FindCaveStartChunksNear(IntVec2 const& chunkCoords, unsigned int worldCaveSeed, std::vector<IntVec2>& out_startChunkCoords)
+{
+	//Search all chunks in a large rectangular region around us for possible cave start locations
+	IntVec2 chunkSearchMins = chunkCoords - IntVec2(CAVE_SEARCH_RADIUS, CAVE_SEARCH_RADIUS);
+	IntVec2 chunkSearchMaxs = chunkCoords + IntVec2(CAVE_SEARCH_RADIUS, CAVE_SEARCH_RADIUS);
+	for (int chunkY = chunkSearchMins.y; chunkY <= chunkSearchMaxs.y; chunkY++)
+	{
+		for (int chunkX = chunkSearchMins.x; chunkX <= chunkSearchMaxs.x; chunkX++)
+		{
+			float caveOriginationNoise = Get2dNoiseZeroToOne(chunkX, chunkY, worldCaveSeed);
+			if (caveOriginationNoise < CHANCE_FOR_CAVE_TO_START_IN_A_CHUNK)
+			{
+				//make a note that "a cave definitely starts somewhere in a chunk"
+				out_startChunkCoords.push_back(IntVec2(chunkX, chunkY));
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void CaveCache::ComputeCave(unsigned int worldCaveSeed, CaveInfo& inout_cave)
+{
+	//Create a unique seed for THIS CAVE from its start chunk only, so every chunk that carves it sees the same path
+	unsigned int seedForThisCave = Get2dNoiseUint(inout_cave.m_startChunkCoords.x, inout_cave.m_startChunkCoords.y, worldCaveSeed + 1);
+	RandomNumberGenerator caveRng(seedForThisCave);
+
+	//Pick a random starting position withing the cave's starting chunk (which is prolly not me)
+	AABB3 startChunkBounds = Chunk::GetChunkBoundsForChunkCoords(inout_cave.m_startChunkCoords);
+	inout_cave.m_startWorldPos.x = caveRng.RollRandomFloatInRange(startChunkBounds.m_mins.x, startChunkBounds.m_maxs.x);
+	inout_cave.m_startWorldPos.y = caveRng.RollRandomFloatInRange(startChunkBounds.m_mins.y, startChunkBounds.m_maxs.y);
+	inout_cave.m_startWorldPos.z = caveRng.RollRandomFloatInRange(30.f, 50.f);
+	EulerAngles crawlOrientation;
+	crawlOrientation.m_yawDegrees = caveRng.RollRandomFloatInRange(0.f, 360.f);
+	crawlOrientation.m_pitchDegrees = 0.f;
+	crawlOrientation.m_rollDegrees = 0.f;
+
+	//Note the starting pos, then start crawling
+	Vec3 crawlWorldPosition = inout_cave.m_startWorldPos;
+	inout_cave.m_caveNodePositions.reserve(CAVE_NUM_CRAWL_STEPS);
+	for (int crawlStep = 0; crawlStep < CAVE_NUM_CRAWL_STEPS; crawlStep++)
+	{
+		Vec3 forwardDisplacement = CAVE_STEP_LENGTH * crawlOrientation.GetForwardVector();
+		crawlWorldPosition += forwardDisplacement;
+		crawlOrientation.m_yawDegrees += caveRng.RollRandomFloatInRange(-CAVE_MAX_TURN_DEGREES, CAVE_MAX_TURN_DEGREES);
+		float noise = Compute1dPerlinNoise(float(crawlStep), 5.f, 3, 0.5f, 2.f, true, seedForThisCave + 5);
+		crawlOrientation.m_pitchDegrees = RangeMapClamped(noise, -1.f, 1.f, -89.f, 89.f);
+		inout_cave.m_caveNodePositions.push_back(crawlWorldPosition);
+	}
+
+	BuildSegmentIndex(inout_cave);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsSegmentChunkBefore(CaveSegment const& segment, IntVec2 const& chunkCoords)
+{
+	return segment.m_chunkCoords < chunkCoords;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsSegmentChunkOrderLess(CaveSegment const& segmentA, CaveSegment const& segmentB)
+{
+	return segmentA.m_chunkCoords < segmentB.m_chunkCoords;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Lists every capsule segment once for each chunk column its XY bounds (grown by the radius) touch. The rest of the
+// overlap test stays in CarveCapsule3D, so chunks carve exactly what they carved when they tested every segment.
+void CaveCache::BuildSegmentIndex(CaveInfo& inout_cave)
+{
+	inout_cave.m_segmentsByChunk.clear();
+	for (int caveNodeIndex = 0; caveNodeIndex < (int)inout_cave.m_caveNodePositions.size(); caveNodeIndex++)
+	{
+		CaveSegment segment;
+		segment.m_start = (caveNodeIndex == 0) ? inout_cave.m_startWorldPos : Vec3(inout_cave.m_caveNodePositions[caveNodeIndex - 1]);
+		segment.m_end = inout_cave.m_caveNodePositions[caveNodeIndex];
+
+		int minChunkX = RoundDownToInt(std::min(segment.m_start.x, segment.m_end.x) - CAVE_RADIUS) >> CHUNK_BITS_X;
+		int maxChunkX = RoundDownToInt(std::max(segment.m_start.x, segment.m_end.x) + CAVE_RADIUS) >> CHUNK_BITS_X;
+		int minChunkY = RoundDownToInt(std::min(segment.m_start.y, segment.m_end.y) - CAVE_RADIUS) >> CHUNK_BITS_Y;
+		int maxChunkY = RoundDownToInt(std::max(segment.m_start.y, segment.m_end.y) + CAVE_RADIUS) >> CHUNK_BITS_Y;
+		for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++)
+		{
+			for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++)
+			{
+				segment.m_chunkCoords = IntVec2(chunkX, chunkY);
+				inout_cave.m_segmentsByChunk.push_back(segment);
+			}
+		}
+	}
+
+	//Stable so each chunk still carves its segments in crawl order
+	std::stable_sort(inout_cave.m_segmentsByChunk.begin(), inout_cave.m_segmentsByChunk.end(), IsSegmentChunkOrderLess);
+	inout_cave.m_segmentsByChunk.shrink_to_fit();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Index of the cave's first segment listed for chunkCoords, or the segment count if none overlaps that chunk
+int CaveCache::FindFirstSegmentInChunk(CaveInfo const& cave, IntVec2 const& chunkCoords)
+{
+	auto segmentIt = std::lower_bound(cave.m_segmentsByChunk.begin(), cave.m_segmentsByChunk.end(), chunkCoords, IsSegmentChunkBefore);
+	return (int)(segmentIt - cave.m_segmentsByChunk.begin());
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
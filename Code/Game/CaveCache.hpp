@@ -0,0 +1,37 @@
+#pragma once
+#include "Game/Chunks.hpp"
+#include "Game/SharedLRUCache.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <memory>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// World-level cache of worm cave paths keyed by the chunk each cave starts in, shared by every generation thread.
+// A cave's start position and node list only depend on its start chunk and the world cave seed, so each path is crawled
+// once and every chunk within reach of it carves from the same copy instead of re-simulating the crawl.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class CaveCache
+{
+public:
+	CaveCache(unsigned int worldCaveSeed, int maxCachedCaves = DEFAULT_MAX_CACHED_CAVES);
+
+	std::shared_ptr<CaveInfo const>	GetCave(IntVec2 const& startChunkCoords);
+	unsigned int					GetWorldCaveSeed() const { return m_worldCaveSeed; }
+	int								GetNumCachedCaves();
+
+	static void			FindCaveStartChunksNear(IntVec2 const& chunkCoords, unsigned int worldCaveSeed, std::vector<IntVec2>& out_startChunkCoords);
+	static void			ComputeCave(unsigned int worldCaveSeed, CaveInfo& inout_cave);
+	static int			FindFirstSegmentInChunk(CaveInfo const& cave, IntVec2 const& chunkCoords);
+
+public:
+	static constexpr int	DEFAULT_MAX_CACHED_CAVES = 1024;
+	static constexpr float	CAVE_RADIUS = 5.f;
+
+private:
+	static void			BuildSegmentIndex(CaveInfo& inout_cave);
+	static size_t		GetCaveBytes(CaveInfo const& cave);
+
+	unsigned int								m_worldCaveSeed = 0;
+	SharedLRUCache<IntVec2, CaveInfo>			m_caves;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+#include "Game/ChunkLifecycle.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/Chunks.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/World.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::vector<double>		ChunkLifecycle::s_stageSeconds[NUM_CHUNK_LIFECYCLE_STAGES];
+int						ChunkLifecycle::s_numDroppedSamples = 0;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void ChunkLifecycle::RecordChunk(Chunk const* chunk)
+{
+	double const* eventSeconds = chunk->m_lifecycleSeconds;
+
+	//Chunks built by hand (benchmarks, fingerprints) never went through the job queue
+	if (eventSeconds[CHUNK_LIFECYCLE_QUEUED] <= 0.0)
+	{
+		return;
+	}
+
+	AddSample(CHUNK_STAGE_QUEUE_WAIT, eventSeconds[CHUNK_LIFECYCLE_QUEUED], eventSeconds[CHUNK_LIFECYCLE_JOB_STARTED]);
+	AddSample(chunk->m_wasLoadedFromDisk ? CHUNK_STAGE_LOAD : CHUNK_STAGE_GENERATE, eventSeconds[CHUNK_LIFECYCLE_JOB_STARTED], eventSeconds[CHUNK_LIFECYCLE_JOB_FINISHED]);
+	AddSample(CHUNK_STAGE_RETRIEVE, eventSeconds[CHUNK_LIFECYCLE_JOB_FINISHED], eventSeconds[CHUNK_LIFECYCLE_ACTIVATED]);
+	AddSample(CHUNK_STAGE_NEIGHBOR_WAIT, eventSeconds[CHUNK_LIFECYCLE_ACTIVATED], eventSeconds[CHUNK_LIFECYCLE_NEIGHBORS_READY]);
+	AddSample(CHUNK_STAGE_MESH_BUDGET_WAIT, eventSeconds[CHUNK_LIFECYCLE_NEIGHBORS_READY], eventSeconds[CHUNK_LIFECYCLE_MESH_STARTED]);
+	AddSample(CHUNK_STAGE_MESH_BUILD, eventSeconds[CHUNK_LIFECYCLE_MESH_STARTED], eventSeconds[CHUNK_LIFECYCLE_MESH_BUILT]);
+	AddSample(CHUNK_STAGE_TOTAL, eventSeconds[CHUNK_LIFECYCLE_REQUESTED], eventSeconds[CHUNK_LIFECYCLE_MESH_BUILT]);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void ChunkLifecycle::AddSample(ChunkLifecycleStage stage, double startSeconds, double endSeconds)
+{
+	if (startSeconds <= 0.0 || endSeconds <= 0.0)
+	{
+		return;
+	}
+	if ((int)s_stageSeconds[stage].size() >= MAX_SAMPLES_PER_STAGE)
+	{
+		s_numDroppedSamples++;
+		return;
+	}
+
+	s_stageSeconds[stage].push_back(std::max(endSeconds - startSeconds, 0.0));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+char const* ChunkLifecycle::GetStageName(ChunkLifecycleStage stage)
+{
+	switch (stage)
+	{
+		case CHUNK_STAGE_QUEUE_WAIT:			return "queueWait";
+		case CHUNK_STAGE_GENERATE:				return "generate";
+		case CHUNK_STAGE_LOAD:					return "load";
+		case CHUNK_STAGE_RETRIEVE:				return "retrieve";
+		case CHUNK_STAGE_NEIGHBOR_WAIT:			return "neighborWait";
+		case CHUNK_STAGE_MESH_BUDGET_WAIT:		return "meshBudgetWait";
+		case CHUNK_STAGE_MESH_BUILD:			return "meshBuild";
+		case CHUNK_STAGE_TOTAL:					return "total";
+		default:								return "unknown";
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void ChunkLifecycle::Reset()
+{
+	for (int stageIndex = 0; stageIndex < NUM_CHUNK_LIFECYCLE_STAGES; stageIndex++)
+	{
+		s_stageSeconds[stageIndex].clear();
+	}
+	s_numDroppedSamples = 0;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void ChunkLifecycle::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("ChunkLifecycle", ChunkLifecycle::Event_ChunkLifecycle);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// ChunkLifecycle reset=false
+//	Prints latency percentiles per stage for every chunk that reached its first mesh, then the chunks of the running world
+//	that are still active without a mesh, split by whether they wait for neighbors or for a rebuild slot.
+bool ChunkLifecycle::Event_ChunkLifecycle(EventArgs& args)
+{
+	bool shouldReset = args.GetValue("reset", false);
+
+	for (int stageIndex = 0; stageIndex < NUM_CHUNK_LIFECYCLE_STAGES; stageIndex++)
+	{
+		std::vector<double> sortedSeconds = s_stageSeconds[stageIndex];
+		std::sort(sortedSeconds.begin(), sortedSeconds.end());
+		PrintToConsole(Stringf("ChunkLifecycle %-14s: chunks=%i, p50=%.2fms, p95=%.2fms, p99=%.2fms, max=%.2fms",
+			GetStageName(static_cast<ChunkLifecycleStage>(stageIndex)), (int)sortedSeconds.size(),
+			1000.0 * Benchmark::GetPercentile(sortedSeconds, 0.5f), 1000.0 * Benchmark::GetPercentile(sortedSeconds, 0.95f),
+			1000.0 * Benchmark::GetPercentile(sortedSeconds, 0.99f), 1000.0 * Benchmark::GetPercentile(sortedSeconds, 1.f)), Rgba8(0, 255, 255, 255));
+	}
+
+	if (g_theGame != nullptr && g_theGame->m_world != nullptr)
+	{
+		World* world = g_theGame->m_world;
+		double nowSeconds = GetCurrentTimeSeconds();
+		int numWaitingForNeighbors = 0;
+		int numWaitingForMesh = 0;
+		double oldestNeighborWaitSeconds = 0.0;
+		double oldestMeshWaitSeconds = 0.0;
+		for (auto chunkIt = world->m_activeChunks.begin(); chunkIt != world->m_activeChunks.end(); ++chunkIt)
+		{
+			Chunk const* chunk = chunkIt->second;
+			if (chunk->m_lifecycleSeconds[CHUNK_LIFECYCLE_MESH_BUILT] > 0.0)
+			{
+				continue;
+			}
+
+			if (chunk->HasAllValidNeighbours())
+			{
+				numWaitingForMesh++;
+				oldestMeshWaitSeconds = std::max(oldestMeshWaitSeconds, nowSeconds - chunk->m_lifecycleSeconds[CHUNK_LIFECYCLE_ACTIVATED]);
+			}
+			else
+			{
+				numWaitingForNeighbors++;
+				oldestNeighborWaitSeconds = std::max(oldestNeighborWaitSeconds, nowSeconds - chunk->m_lifecycleSeconds[CHUNK_LIFECYCLE_ACTIVATED]);
+			}
+		}
+		PrintToConsole(Stringf("ChunkLifecycle now: %i chunks in load/generate, %i active waiting for neighbors (oldest %.2fs), %i waiting for a mesh slot (oldest %.2fs)",
+			(int)world->m_initializedChunks.size(), numWaitingForNeighbors, oldestNeighborWaitSeconds, numWaitingForMesh, oldestMeshWaitSeconds),
+			Rgba8(255, 255, 0, 255));
+	}
+	PrintToConsole(Stringf("ChunkLifecycle: %i samples dropped", s_numDroppedSamples), Rgba8(255, 255, 0, 255));
+
+	if (shouldReset)
+	{
+		Reset();
+		PrintToConsole("ChunkLifecycle: reset", Rgba8(0, 255, 255, 255));
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
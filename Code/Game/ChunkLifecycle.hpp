@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class Chunk;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Milestones a streamed chunk passes on its way from being requested to being drawn, stamped once each by Chunk
+enum ChunkLifecycleEvent
+{
+	CHUNK_LIFECYCLE_REQUESTED,			//World::InitializeChunk created the chunk (MISSING)
+	CHUNK_LIFECYCLE_QUEUED,				//load or generate job queued
+	CHUNK_LIFECYCLE_JOB_STARTED,		//worker began loading or generating
+	CHUNK_LIFECYCLE_JOB_FINISHED,		//ACTIVATING_LOAD_COMPLETE or ACTIVATING_GENERATE_COMPLETE
+	CHUNK_LIFECYCLE_ACTIVATED,			//ACTIVE, linked to neighbors and lit
+	CHUNK_LIFECYCLE_NEIGHBORS_READY,	//dirty with all four neighbors present, so eligible for a mesh rebuild
+	CHUNK_LIFECYCLE_MESH_STARTED,		//first RebuildMesh picked this chunk
+	CHUNK_LIFECYCLE_MESH_BUILT,			//first RebuildMesh finished, including the GPU upload
+	NUM_CHUNK_LIFECYCLE_EVENTS
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum ChunkLifecycleStage
+{
+	CHUNK_STAGE_QUEUE_WAIT,				//QUEUED -> JOB_STARTED
+	CHUNK_STAGE_GENERATE,				//JOB_STARTED -> JOB_FINISHED for generated chunks
+	CHUNK_STAGE_LOAD,					//JOB_STARTED -> JOB_FINISHED for chunks loaded from disk
+	CHUNK_STAGE_RETRIEVE,				//JOB_FINISHED -> ACTIVATED
+	CHUNK_STAGE_NEIGHBOR_WAIT,			//ACTIVATED -> NEIGHBORS_READY
+	CHUNK_STAGE_MESH_BUDGET_WAIT,		//NEIGHBORS_READY -> MESH_STARTED, waiting for one of the per-frame rebuild slots
+	CHUNK_STAGE_MESH_BUILD,				//MESH_STARTED -> MESH_BUILT
+	CHUNK_STAGE_TOTAL,					//REQUESTED -> MESH_BUILT
+	NUM_CHUNK_LIFECYCLE_STAGES
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Per-stage latency distributions over every streamed chunk that reached its first mesh, to find where terrain holes come from
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class ChunkLifecycle
+{
+public:
+	static void			RecordChunk(Chunk const* chunk);
+	static char const*	GetStageName(ChunkLifecycleStage stage);
+	static void			Reset();
+
+	static void			RegisterCommands();
+	static bool			Event_ChunkLifecycle(EventArgs& args);
+
+public:
+	static constexpr int MAX_SAMPLES_PER_STAGE = 100000;
+
+private:
+	static void			AddSample(ChunkLifecycleStage stage, double startSeconds, double endSeconds);
+
+	static std::vector<double>	s_stageSeconds[NUM_CHUNK_LIFECYCLE_STAGES];
+	static int					s_numDroppedSamples;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1,21 +1,59 @@
 #include "Game/Chunks.hpp"
-#include "Engine/Renderer/VertexBuffer.hpp"
 #include "Game/World.hpp"
 #include "Game/BlockIterator.hpp"
 #include "Game/BlockTemplate.hpp"
+#include "Game/CaveCache.hpp"
+#include "Game/ColumnCache.hpp"
+#include "Game/MemoryStats.hpp"
+#include "Game/OreField.hpp"
+#include "Game/PendingBlockWrites.hpp"
+#include "Game/PerfCounters.hpp"
+#include "Game/Profiler.hpp"
 #include "ThirdParty/Squirrel/SmoothNoise.hpp"
 #include "ThirdParty/Squirrel/RawNoise.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Core/Time.hpp"
-#include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#if !defined(GAME_HEADLESS)
+#include "Engine/Renderer/VertexBuffer.hpp"
+#endif
 
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// 1: header, seed, block runs. 2: adds m_appliedSpillSources after the seed
+constexpr uint8_t CHUNK_FILE_VERSION = 2;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::atomic<int>		Chunk::s_numFileExistsChecks = 0;
+std::atomic<int>		Chunk::s_numFileReads = 0;
+std::atomic<int>		Chunk::s_numFileWrites = 0;
+std::atomic<int>		Chunk::s_numFolderCreates = 0;
+std::atomic<int64_t>	Chunk::s_numFileBytesRead = 0;
+std::atomic<int64_t>	Chunk::s_numFileBytesWritten = 0;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 Chunk::Chunk(World* world, IntVec2 const& chunkCoords)
-	:m_world(world), m_chunkCoords(chunkCoords)
+	:Chunk(chunkCoords, static_cast<unsigned int>(world->GetWorldSeed()))
+{
+	m_world = world;
+	m_columnCache = world->GetColumnCache();
+	m_caveCache = world->GetCaveCache();
+	m_pendingBlockWrites = world->GetPendingBlockWrites();
+	m_useOreVeins = world->m_useOreVeins;
+	m_useWormCaves = world->m_useWormCaves;
+	RecordLifecycleEvent(CHUNK_LIFECYCLE_REQUESTED);
+	//Generateblocks();
+	InitializeVertexBuffer();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+Chunk::Chunk(IntVec2 const& chunkCoords, unsigned int worldSeed)
+	:m_chunkCoords(chunkCoords), m_worldSeed(worldSeed)
 {
 	m_blocks = new Block[CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z];
+	MemoryStats::Add(MEMORY_CHUNK_BLOCKS, (int64_t)(sizeof(Block) * CHUNK_BLOCKS_TOTAL));
 	
 	m_worldBounds.m_mins.x = (float)CHUNK_SIZE_X * (float)chunkCoords.x;
 	m_worldBounds.m_mins.y = (float)CHUNK_SIZE_Y * (float)chunkCoords.y;
@@ -26,9 +64,6 @@ Chunk::Chunk(World* world, IntVec2 const& chunkCoords)
 	m_worldBounds.m_maxs.z = (float)CHUNK_SIZE_Z;
 	
 	m_numBlocks = CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z;
-	m_worldSeed = m_world->GetWorldSeed();
-	//Generateblocks();
-	InitializeVertexBuffer();
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 Chunk::~Chunk()
@@ -47,8 +82,18 @@ Chunk::~Chunk()
 //  		}
 //  	}
 
+#if !defined(GAME_HEADLESS)
 	delete m_gpuMeshVBO;
+#endif
 	m_gpuMeshVBO = nullptr;
+	PerfCounters::Increment(PERF_GAUGE_MESH_VERTICES, -(int64_t)m_cpuMesh.size());
+
+	ChunkMemoryUsage usage;
+	GetMemoryUsage(usage);
+	MemoryStats::Add(MEMORY_CHUNK_BLOCKS, -(int64_t)usage.m_blockBytes);
+	MemoryStats::Add(MEMORY_CPU_MESH, -(int64_t)usage.m_cpuMeshBytes);
+	MemoryStats::Add(MEMORY_GPU_MESH, -(int64_t)usage.m_gpuMeshBytes);
+	MemoryStats::Add(MEMORY_NEARBY_CAVES, -(int64_t)usage.m_nearbyCavesBytes);
 	
 	delete[] m_blocks; 
 	m_blocks = nullptr;
@@ -64,6 +109,7 @@ void Chunk::Update()
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::Render()
 {	
+#if !defined(GAME_HEADLESS)
 	if (m_world->m_debugUseWhiteBlocks)
 	{
 		g_theRenderer->BindTexture(nullptr);
@@ -73,13 +119,138 @@ void Chunk::Render()
 		g_theRenderer->BindTexture(&g_terrainSpriteSheet->GetTexture());
 	}
 	g_theRenderer->DrawVertexBuffer(m_gpuMeshVBO, (int)(m_cpuMesh.size()));
+#endif
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static ChunkGenerationStageDef const s_generationStageDefs[NUM_GENERATION_STAGES] =
+{
+	{ "terrain",	CHUNK_TERRAIN_JOB_TYPE,		0 },
+	{ "carve",		CHUNK_CARVE_JOB_TYPE,		0 },
+	{ "decorate",	CHUNK_DECORATE_JOB_TYPE,	GENERATION_STAGE_CARVE + 1 },		//decorations may reach into neighbors, so they go on carved terrain
+	{ "light",		CHUNK_LIGHT_JOB_TYPE,		GENERATION_STAGE_DECORATE + 1 },	//every decoration that can shade this chunk is placed
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+ChunkGenerationStageDef const& GetChunkGenerationStageDef(ChunkGenerationStage stage)
+{
+	return s_generationStageDefs[stage];
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Every block-writing stage back to back, without waiting for neighbors; sky light is left to InitializeLighting
 void Chunk::Generateblocks()
 {
-	RandomNumberGenerator rng(m_worldSeed);
-	unsigned int worldCaveSeed = m_worldSeed + 7;
+	PROFILE_SCOPE("Chunk::Generateblocks");
+	for (int stageIndex = GENERATION_STAGE_TERRAIN; stageIndex < GENERATION_STAGE_LIGHT; stageIndex++)
+	{
+		RunGenerationStage(ChunkGenerationStage(stageIndex));
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Chunk::RunGenerationStage(ChunkGenerationStage stage)
+{
+	switch (stage)
+	{
+		case GENERATION_STAGE_TERRAIN:
+			GenerateTerrain();
+			break;
+		case GENERATION_STAGE_CARVE:
+		{
+			size_t oldCavesBytes = GetNearbyCavesBytes();
+			AddCaves(GetWorldCaveSeed());
+			MemoryStats::Add(MEMORY_NEARBY_CAVES, (int64_t)GetNearbyCavesBytes() - (int64_t)oldCavesBytes);
+			if (m_useWormCaves)
+			{
+				GenerateCaves();
+			}
+			break;
+		}
+		case GENERATION_STAGE_DECORATE:
+			AddTrees();
+			break;
+		case GENERATION_STAGE_LIGHT:
+			//every neighbor in range has decorated by now; the others' structures reach this chunk later as late writes
+			ApplyPendingBlockWrites(false);
+			ComputeSkyLight();
+			break;
+		default:
+			break;
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Called on the main thread before queueing numBands ChunkGenerationJobs that each run GenerateBlocksBand
+void Chunk::PrepareGenerationBands(int numBands)
+{
+	m_bandColumns = std::make_shared<ChunkColumns>();
+	m_bandOreVeins = nullptr;
+	if (m_useOreVeins)
+	{
+		m_bandOreVeins = std::make_shared<OreVeinField const>(m_chunkCoords.x * CHUNK_SIZE_X, m_chunkCoords.y * CHUNK_SIZE_Y, GetOreSeed());
+	}
+	m_numGenerationBandsLeft = numBands;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// One row band of the terrain stage: the band computes the columns and terrain of its own rows, and the last band to finish
+// publishes the columns to the cache. Returns true for that last band.
+bool Chunk::GenerateBlocksBand(int bandIndex, int numBands)
+{
+	PROFILE_SCOPE("Chunk::GenerateBlocksBand");
+	int minLocalY = (bandIndex * CHUNK_SIZE_Y) / numBands;
+	int maxLocalY = ((bandIndex + 1) * CHUNK_SIZE_Y) / numBands;
+
+	ColumnCacheConfig columnConfig;
+	columnConfig.m_worldSeed = m_worldSeed;
+	if (m_columnCache != nullptr)
+	{
+		columnConfig = m_columnCache->GetConfig();
+	}
+	ColumnCache::ComputeChunkColumns(m_chunkCoords, columnConfig, *m_bandColumns, minLocalY, maxLocalY);
+	GenerateTerrainRows(*m_bandColumns, m_bandOreVeins.get(), minLocalY, maxLocalY);
+
+	//The atomic decrement also makes every other band's rows visible to the band that finishes
+	if (m_numGenerationBandsLeft.fetch_sub(1) != 1)
+	{
+		return false;
+	}
 
+	if (m_columnCache != nullptr)
+	{
+		m_columnCache->InsertChunkColumns(m_chunkCoords, m_bandColumns);
+	}
+	m_bandColumns = nullptr;
+	m_bandOreVeins = nullptr;
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Material boundaries of one terrain column, found before any block is written
+struct TerrainColumnRuns
+{
+	int			m_dirtMinZ = 0;
+	int			m_sandMinZ = 0;			//dirt above this is sand
+	int			m_groundHeightZ = 0;
+	int			m_iceMinZ = 0;			//water above this is ice
+	int			m_freezeLevel = 0;
+	bool		m_hasCloud = false;
+	BlockDefID	m_surfaceType = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Chunk::GenerateTerrain()
+{
+	PROFILE_SCOPE("Chunk::GenerateTerrain");
+	std::shared_ptr<ChunkColumns const> chunkColumns = GetChunkColumns();
+	if (m_useOreVeins)
+	{
+		OreVeinField oreVeins(m_chunkCoords.x * CHUNK_SIZE_X, m_chunkCoords.y * CHUNK_SIZE_Y, GetOreSeed());
+		GenerateTerrainRows(*chunkColumns, &oreVeins, 0, CHUNK_SIZE_Y);
+	}
+	else
+	{
+		GenerateTerrainRows(*chunkColumns, nullptr, 0, CHUNK_SIZE_Y);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Terrain of rows [minLocalY, maxLocalY) only; it reads and writes nothing outside them, so row bands can run in parallel.
+// Ores come from the chunk's vein lattices when oreVeins is given, otherwise from independent per-block hashes.
+void Chunk::GenerateTerrainRows(ChunkColumns const& chunkColumns, OreVeinField const* oreVeins, int minLocalY, int maxLocalY)
+{
 	static BlockDefID dirt = BlockDef::GetBlockDefIDByName("dirt");
 	static BlockDefID coal = BlockDef::GetBlockDefIDByName("coal");
 	static BlockDefID diamond = BlockDef::GetBlockDefIDByName("diamond");
@@ -98,28 +269,30 @@ void Chunk::Generateblocks()
 	int maxIceDepth = 20;
 	int maxSandDepth = 8;
 	int oceanHeightZ = CHUNK_SIZE_Z / 2;
-	int freezeLevel = 0;
+	int cloudHeightZ = 125;
 
-	int   groundHeightZ = 0;
-	float temperature = 0.f;
-	float humidity = 0.f;
-	float cloudness = 0.f;
+	//Dirt depth and ores are hashed from global positions, so columns and layers can be filled in any order
+	unsigned int dirtDepthSeed = m_worldSeed + 12;
+	unsigned int oreSeed = GetOreSeed();
+	int chunkMinsX = m_chunkCoords.x * CHUNK_SIZE_X;
+	int chunkMinsY = m_chunkCoords.y * CHUNK_SIZE_Y;
 
-	for (int localY = 0; localY < CHUNK_SIZE_Y; localY++)
-	{
-		float globalY = m_worldBounds.m_mins.y + float(localY);
+	//Pass 1: find each column's runs
+	TerrainColumnRuns columnRuns[CHUNK_BLOCKS_PER_LAYER];
+	int lowestDirtMinZ = CHUNK_SIZE_Z;
+	int highestDirtMinZ = 0;
+	int highestNonAirZ = oceanHeightZ;
 
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
 		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
 		{
-			float globalX = m_worldBounds.m_mins.x + float(localX);
-
 			//Determine biome factors for this column
-			temperature = 0.5f + 0.5f * Compute2dPerlinNoise(globalX, globalY, 800.f, 9, 0.5f, 2.f, true, m_worldSeed + 1);
-			temperature += 0.01f * Get2dNoiseZeroToOne(static_cast<int>(globalX), static_cast<int>(globalY), m_worldSeed + 21);
-			humidity = 0.5f + 0.5f * Compute2dPerlinNoise(globalX, globalY, 800.f, 5, 0.5f, 2.f, true, m_worldSeed + 2);
-			cloudness = RangeMapClamped(Compute2dPerlinNoise(globalX, globalY, 30.f, 9, 0.5f, 2.f, true, m_worldSeed + 9), -1.f, 1.f, 0.f, 1.f);
-
-			groundHeightZ = CalculateGroundZHeightForGlobalXY(globalX, globalY);
+			ColumnData const& column = chunkColumns.GetColumn(localX, localY);
+			float temperature = column.m_temperature;
+			float humidity = column.m_humidity;
+			float cloudness = column.m_cloudness;
+			int groundHeightZ = column.m_groundHeightZ;
 			
 			//Calculate ice depth(should be zero for areas with no ice) based on [lowness of] temp.
 			int iceDepth = RoundDownToInt(RangeMapClamped(temperature, 0.f, 0.4f, float(maxIceDepth), 0.f));
@@ -128,92 +301,124 @@ void Chunk::Generateblocks()
 			//Calculate sand depth(should be zero for areas with no sand) based on [lowness of] humidity.
 			int sandDepth = RoundDownToInt(RangeMapClamped(humidity, 0.f, 0.4f, float(maxSandDepth), 0.f));
 			int sandHeightZ = groundHeightZ - sandDepth;
-			freezeLevel = oceanHeightZ + static_cast<int>(temperature * 50);
-
-			int dirtMinZ = groundHeightZ - rng.RollRandomIntInRange(3, 4);
-
-			for (int localZ = 0; localZ < CHUNK_SIZE_Z; localZ++)
+			int freezeLevel = oceanHeightZ + static_cast<int>(temperature * 50);
+
+			int dirtMinZ = groundHeightZ - 3 - (int)(Get2dNoiseUint(chunkMinsX + localX, chunkMinsY + localY, dirtDepthSeed) & 1);
+
+			TerrainColumnRuns& runs = columnRuns[localX + (localY << CHUNK_BITS_X)];
+			runs.m_dirtMinZ = dirtMinZ;
+			runs.m_sandMinZ = sandHeightZ + 1;
+			runs.m_groundHeightZ = groundHeightZ;
+			runs.m_iceMinZ = iceHeightZ + 1;
+			runs.m_freezeLevel = freezeLevel;
+			runs.m_hasCloud = cloudness > 0.7f;
+			runs.m_surfaceType = grass;
+			if ((humidity < 0.65f && groundHeightZ == oceanHeightZ) || groundHeightZ > sandHeightZ)
 			{
-				BlockDefID blockType = air;
-
-				if (localZ < dirtMinZ)
-				{
-					blockType = stone;
-
-					if (rng.RollRandomChance(0.05f))
-						blockType = coal;
-
-					if (rng.RollRandomChance(0.02f))
-						blockType = iron;
-
-					if (rng.RollRandomChance(0.005f))
-						blockType = gold;
-
-					if (rng.RollRandomChance(0.001f))
-						blockType = diamond;
-				}
+				runs.m_surfaceType = sand;
+			}
 
-				else if (localZ < groundHeightZ)
-				{
-					blockType = dirt;
-					if (localZ > sandHeightZ)
-					{
-						blockType = sand;
-					}
-				}
+			lowestDirtMinZ = std::min(lowestDirtMinZ, dirtMinZ);
+			highestDirtMinZ = std::max(highestDirtMinZ, dirtMinZ);
+			highestNonAirZ = std::max(highestNonAirZ, groundHeightZ);
+			if (runs.m_hasCloud)
+			{
+				highestNonAirZ = std::max(highestNonAirZ, cloudHeightZ);
+			}
+		}
+	}
 
-				else if (localZ == groundHeightZ)
-				{
-					blockType = grass;
+	//Pass 2: layers that are stone or air in every column are filled whole
+	FillLayerRows(0, lowestDirtMinZ, minLocalY, maxLocalY, stone);
+	FillLayerRows(highestNonAirZ + 1, CHUNK_SIZE_Z, minLocalY, maxLocalY, air);
 
-					if (humidity < 0.65f && localZ == oceanHeightZ)
-					{
-						blockType = sand;
-					}
-					if (localZ > sandHeightZ)
-					{
-						blockType = sand;
-					}
-				}
-				else if (localZ <= oceanHeightZ && blockType == air)
-				{
-					blockType = water;
-					if (localZ > iceHeightZ)
-					{
-						blockType = ice;
-					}
-				}
+	//Pass 3: the band in between, one run per material per column; later runs overwrite earlier ones like the old branches did
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			TerrainColumnRuns const& runs = columnRuns[localX + (localY << CHUNK_BITS_X)];
+			int groundHeightZ = runs.m_groundHeightZ;
+
+			FillColumnSpan(localX, localY, lowestDirtMinZ, runs.m_dirtMinZ, stone);
+			FillColumnSpan(localX, localY, runs.m_dirtMinZ, std::min(groundHeightZ, runs.m_sandMinZ), dirt);
+			FillColumnSpan(localX, localY, std::max(runs.m_dirtMinZ, runs.m_sandMinZ), groundHeightZ, sand);
+			FillColumnSpan(localX, localY, groundHeightZ, groundHeightZ + 1, runs.m_surfaceType);
+			FillColumnSpan(localX, localY, groundHeightZ + 1, std::min(oceanHeightZ + 1, runs.m_iceMinZ), water);
+			FillColumnSpan(localX, localY, std::max(groundHeightZ + 1, runs.m_iceMinZ), oceanHeightZ + 1, ice);
+			FillColumnSpan(localX, localY, std::max(groundHeightZ, oceanHeightZ) + 1, highestNonAirZ + 1, air);
+
+			if (runs.m_hasCloud)
+			{
+				FillColumnSpan(localX, localY, cloudHeightZ, cloudHeightZ + 1, cloud);
+			}
 
-				if (localZ == 125)
-				{
-					if (cloudness > 0.7f)
-						blockType = cloud;
-				}
+			if (runs.m_freezeLevel <= groundHeightZ)
+			{
+				FillColumnSpan(localX, localY, runs.m_freezeLevel + 1, groundHeightZ + 1, snow);
+				FillColumnSpan(localX, localY, runs.m_freezeLevel, runs.m_freezeLevel + 1, snowgrass);
+			}
+		}
+	}
 
-				if (localZ >= freezeLevel && localZ <= groundHeightZ)
-				{
-					if (localZ == freezeLevel)
-					{
-						blockType = snowgrass;
-					}
-					else
-					{
-						blockType = snow;
-					}
-				}
+	//Pass 4: ores a layer at a time, from clustered veins or independent per-block hashes; they only replace stone that
+	//no cloud or snow run covered
+	BlockDefID const oreBlockTypes[NUM_ORE_TYPES] = { stone, coal, iron, gold, diamond };
+	uint8_t oreTypes[CHUNK_BLOCKS_PER_LAYER];
+	int oreMaxZ = std::min(highestDirtMinZ, CHUNK_SIZE_Z);
+	if (oreVeins != nullptr)
+	{
+		oreMaxZ = std::min(oreMaxZ, oreVeins->GetMaxZ());
+	}
+	for (int localZ = 0; localZ < oreMaxZ; localZ++)
+	{
+		if (oreVeins != nullptr)
+		{
+			oreVeins->ComputeLayer(localZ, oreTypes, minLocalY, maxLocalY);
+		}
+		else
+		{
+			ComputeOreLayer(chunkMinsX, chunkMinsY, localZ, oreSeed, oreTypes, minLocalY, maxLocalY);
+		}
+		Block* layerBlocks = &m_blocks[localZ * CHUNK_BLOCKS_PER_LAYER];
+		for (int columnIndex = minLocalY * CHUNK_SIZE_X; columnIndex < maxLocalY * CHUNK_SIZE_X; columnIndex++)
+		{
+			if (oreTypes[columnIndex] == ORE_NONE)
+			{
+				continue;
+			}
 
-				SetBlockType(localX, localY, localZ, blockType);
+			TerrainColumnRuns const& runs = columnRuns[columnIndex];
+			bool isStone = localZ < runs.m_dirtMinZ && localZ < runs.m_freezeLevel && !(localZ == cloudHeightZ && runs.m_hasCloud);
+			if (isStone)
+			{
+				layerBlocks[columnIndex].SetTypeID(oreBlockTypes[oreTypes[columnIndex]]);
 			}
 		}
 	}
-	
-	AddTrees();
-	AddCaves(worldCaveSeed);
-	
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int Chunk::GetOreSeed() const
+{
+	return m_worldSeed + 13;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int Chunk::GetWorldCaveSeed() const
+{
+	return GetWorldCaveSeedForWorldSeed(m_worldSeed);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int Chunk::GetWorldCaveSeedForWorldSeed(unsigned int worldSeed)
+{
+	return worldSeed + 7;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::RebuildMesh()
 {
+	PROFILE_SCOPE("Chunk::RebuildMesh");
+	RecordLifecycleEvent(CHUNK_LIFECYCLE_MESH_STARTED);
+	int64_t numOldVerts = (int64_t)m_cpuMesh.size();
+	size_t oldCpuMeshCapacity = m_cpuMesh.capacity();
 	m_cpuMesh.clear();
 
 	for (int localZ = 0; localZ < CHUNK_SIZE_Z; localZ++)
@@ -227,12 +432,31 @@ void Chunk::RebuildMesh()
 		}
 	}
 
+#if !defined(GAME_HEADLESS)
 	if (m_gpuMeshVBO != nullptr)
 	{
-		g_theRenderer->CopyCPUToGPU(m_cpuMesh.data(), m_cpuMesh.size() * sizeof(Vertex_PCU), m_gpuMeshVBO);
+		size_t meshBytes = m_cpuMesh.size() * sizeof(Vertex_PCU);
+		g_theRenderer->CopyCPUToGPU(m_cpuMesh.data(), meshBytes, m_gpuMeshVBO);
+
+		//The VBO is only reallocated when the new mesh does not fit, so it holds the largest upload so far
+		if (meshBytes > m_gpuMeshBytes)
+		{
+			MemoryStats::Add(MEMORY_GPU_MESH, (int64_t)(meshBytes - m_gpuMeshBytes));
+			m_gpuMeshBytes = meshBytes;
+		}
 	}
+#endif
 
+	MemoryStats::Add(MEMORY_CPU_MESH, ((int64_t)m_cpuMesh.capacity() - (int64_t)oldCpuMeshCapacity) * (int64_t)sizeof(Vertex_PCU));
+	PerfCounters::Increment(PERF_COUNTER_MESHES_REBUILT);
+	PerfCounters::Increment(PERF_GAUGE_MESH_VERTICES, (int64_t)m_cpuMesh.size() - numOldVerts);
 	m_isChunkDirty = false;
+
+	if (m_lifecycleSeconds[CHUNK_LIFECYCLE_MESH_BUILT] == 0.0)
+	{
+		RecordLifecycleEvent(CHUNK_LIFECYCLE_MESH_BUILT);
+		ChunkLifecycle::RecordChunk(this);
+	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::SetBlockType(int localX, int localY, int localZ, BlockDefID blockType)
@@ -247,6 +471,54 @@ void Chunk::SetBlockType(int localX, int localY, int localZ, BlockDefID blockTyp
 	m_isChunkDirty = true;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Sets blocks [minZ, maxZ) of column (localX, localY); the range is clamped to the chunk
+void Chunk::FillColumnSpan(int localX, int localY, int minZ, int maxZ, BlockDefID blockType)
+{
+	minZ = std::max(minZ, 0);
+	maxZ = std::min(maxZ, CHUNK_SIZE_Z);
+	if (minZ >= maxZ || !IsInBoundsLocal(localX, localY, 0))
+	{
+		return;
+	}
+
+	Block* columnBlocks = &m_blocks[GetBlockIndex(localX, localY, 0)];
+	for (int localZ = minZ; localZ < maxZ; localZ++)
+	{
+		columnBlocks[localZ * CHUNK_BLOCKS_PER_LAYER].SetTypeID(blockType);
+	}
+	m_isChunkDirty = true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Sets every block of layers [minZ, maxZ), which are contiguous in m_blocks; the range is clamped to the chunk
+void Chunk::FillLayers(int minZ, int maxZ, BlockDefID blockType)
+{
+	FillLayerRows(minZ, maxZ, 0, CHUNK_SIZE_Y, blockType);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Sets rows [minLocalY, maxLocalY) of layers [minZ, maxZ); those rows are one contiguous run per layer
+void Chunk::FillLayerRows(int minZ, int maxZ, int minLocalY, int maxLocalY, BlockDefID blockType)
+{
+	minZ = std::max(minZ, 0);
+	maxZ = std::min(maxZ, CHUNK_SIZE_Z);
+	minLocalY = std::max(minLocalY, 0);
+	maxLocalY = std::min(maxLocalY, CHUNK_SIZE_Y);
+	if (minZ >= maxZ || minLocalY >= maxLocalY)
+	{
+		return;
+	}
+
+	int numBlocksPerLayer = (maxLocalY - minLocalY) * CHUNK_SIZE_X;
+	for (int localZ = minZ; localZ < maxZ; localZ++)
+	{
+		Block* rowBlocks = &m_blocks[GetBlockIndex(0, minLocalY, localZ)];
+		for (int blockIndex = 0; blockIndex < numBlocksPerLayer; blockIndex++)
+		{
+			rowBlocks[blockIndex].SetTypeID(blockType);
+		}
+	}
+	m_isChunkDirty = true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::SetBlockTypeID(IntVec3 const& localCoords, BlockDefID blockType)
 {
 	SetBlockType(localCoords.x, localCoords.y, localCoords.z, blockType);
@@ -254,13 +526,18 @@ void Chunk::SetBlockTypeID(IntVec3 const& localCoords, BlockDefID blockType)
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::InitializeVertexBuffer()
 {
+	//Headless builds have no renderer; the mesh stays CPU-only and RebuildMesh skips the upload
+#if !defined(GAME_HEADLESS)
 	if (m_gpuMeshVBO != nullptr)
 	{
 		delete m_gpuMeshVBO;
 		m_gpuMeshVBO = nullptr;
+		MemoryStats::Add(MEMORY_GPU_MESH, -(int64_t)m_gpuMeshBytes);
+		m_gpuMeshBytes = 0;
 	}
 
 	m_gpuMeshVBO = g_theRenderer->CreateVertexBuffer(1, sizeof(Vertex_PCU));
+#endif
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 bool Chunk::IsInBoundsLocal(int localX, int localY, int localZ)
@@ -339,6 +616,56 @@ int Chunk::GetChunkMeshVertices()
 	return (int)m_cpuMesh.size();
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+size_t Chunk::GetNearbyCavesBytes() const
+{
+	//The caves themselves are shared and counted by the cave cache
+	return m_nearbyCaves.capacity() * sizeof(std::shared_ptr<CaveInfo const>);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Chunk::SetStatus(ChunkState newStatus)
+{
+	m_status = newStatus;
+
+	switch (newStatus)
+	{
+		case ACTIAVTING_QUEUED_LOAD:
+			m_wasLoadedFromDisk = true;
+			RecordLifecycleEvent(CHUNK_LIFECYCLE_QUEUED);
+			break;
+		case ACTIVATING_QUEUED_GENERATE:
+			RecordLifecycleEvent(CHUNK_LIFECYCLE_QUEUED);
+			break;
+		case ACTIVATING_GENERATING:
+			RecordLifecycleEvent(CHUNK_LIFECYCLE_JOB_STARTED);
+			break;
+		case ACTIVATING_LOAD_COMPLETE:
+		case ACTIVATING_GENERATE_COMPLETE:
+			RecordLifecycleEvent(CHUNK_LIFECYCLE_JOB_FINISHED);
+			break;
+		case ACTIVE:
+			RecordLifecycleEvent(CHUNK_LIFECYCLE_ACTIVATED);
+			break;
+		default:
+			break;
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Chunk::RecordLifecycleEvent(ChunkLifecycleEvent lifecycleEvent)
+{
+	if (m_lifecycleSeconds[lifecycleEvent] == 0.0)
+	{
+		m_lifecycleSeconds[lifecycleEvent] = GetCurrentTimeSeconds();
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Chunk::GetMemoryUsage(ChunkMemoryUsage& out_usage) const
+{
+	out_usage.m_blockBytes = (m_blocks != nullptr) ? sizeof(Block) * CHUNK_BLOCKS_TOTAL : 0;
+	out_usage.m_cpuMeshBytes = m_cpuMesh.capacity() * sizeof(Vertex_PCU);
+	out_usage.m_gpuMeshBytes = m_gpuMeshBytes;
+	out_usage.m_nearbyCavesBytes = GetNearbyCavesBytes();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 IntVec2 Chunk::GetChunkCoordinates()
 {
 	return m_chunkCoords;
@@ -424,6 +751,7 @@ int Chunk::GetHighestZNonAirBlock(int localX, int localY)
 bool Chunk::CanBeLoadedFromFile()
 {
 	std::string fileName = GetChunkFileName();
+	s_numFileExistsChecks++;
 	return DoesFileExist(fileName);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -436,12 +764,16 @@ bool Chunk::LoadBlocksFromFile()
 {
 	std::string filePath = Stringf("Saves/World_%u/Chunk(%d,%d).chunk", m_worldSeed, m_chunkCoords.x, m_chunkCoords.y);
 
+	s_numFileExistsChecks++;
 	if (DoesFileExist(filePath))
 	{
 		std::vector<uint8_t> buffer;
 		FileReadToBuffer(buffer, filePath);
+		s_numFileReads++;
+		s_numFileBytesRead += (int64_t)buffer.size();
+		uint8_t fileVersion = buffer[4];
 		if (buffer[0] == 'G' && buffer[1] == 'C' && buffer[2] == 'H' && buffer[3] == 'K' &&
-			buffer[4] == 1 && buffer[5] == CHUNK_BITS_X && buffer[6] == CHUNK_BITS_Y && buffer[7] == CHUNK_BITS_Z)
+			(fileVersion == 1 || fileVersion == CHUNK_FILE_VERSION) && buffer[5] == CHUNK_BITS_X && buffer[6] == CHUNK_BITS_Y && buffer[7] == CHUNK_BITS_Z)
 		{
 			unsigned int seedInFile;
 			memcpy(&seedInFile, &buffer[8], sizeof(unsigned int));
@@ -451,8 +783,17 @@ bool Chunk::LoadBlocksFromFile()
 				return false;
 			}
 
+			//Version 1 chunks re-derived their neighbors' trees while generating, so they already hold every neighbor's blocks
+			int firstRunByte = 12;
+			m_appliedSpillSources = 0xFF;
+			if (fileVersion == CHUNK_FILE_VERSION)
+			{
+				m_appliedSpillSources = buffer[12];
+				firstRunByte = 13;
+			}
+
 			int blockIndex = 0;
-			for (int i = 12; i < buffer.size(); i += 2)
+			for (int i = firstRunByte; i < buffer.size(); i += 2)
 			{
 				uint8_t blockTypeIndex = static_cast<int>(buffer[i]);
 				int numberOfBlocks = static_cast<int>(buffer[i + 1]);
@@ -481,7 +822,7 @@ void Chunk::SaveBlockToFile()
 	buffer.push_back('C');
 	buffer.push_back('H');
 	buffer.push_back('K');
-	buffer.push_back(1);
+	buffer.push_back(CHUNK_FILE_VERSION);
 	buffer.push_back(CHUNK_BITS_X);
 	buffer.push_back(CHUNK_BITS_Y);
 	buffer.push_back(CHUNK_BITS_Z);
@@ -491,6 +832,7 @@ void Chunk::SaveBlockToFile()
 	{
 		buffer.push_back(reinterpret_cast<uint8_t*>(&m_worldSeed)[i]);
 	}
+	buffer.push_back(m_appliedSpillSources);
 
 	uint8_t currentBlockType = m_blocks[0].GetTypeID();
 	uint8_t currentBlockCount = 1;
@@ -522,13 +864,16 @@ void Chunk::SaveBlockToFile()
 	buffer.push_back(currentBlockType);
 	buffer.push_back(currentBlockCount);
 
-	std::string folderPath = Stringf("Saves\\World_%u", m_worldSeed);
+	std::string folderPath = Stringf("Saves/World_%u", m_worldSeed);
+	s_numFileExistsChecks++;
 	if (!DoesFileExist(folderPath))
 	{
 		ForceCreateWorldFolder();
 	}
-	std::string filePath = Stringf("%s\\Chunk(%d,%d).chunk", folderPath.c_str(), m_chunkCoords.x, m_chunkCoords.y);
+	std::string filePath = Stringf("%s/Chunk(%d,%d).chunk", folderPath.c_str(), m_chunkCoords.x, m_chunkCoords.y);
 	FileWriteFromBuffer(buffer, filePath);
+	s_numFileWrites++;
+	s_numFileBytesWritten += (int64_t)buffer.size();
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::DisconnectFromNeighbors()
@@ -573,7 +918,7 @@ void Chunk::AddVertsForBlock(std::vector<Vertex_PCU>& verts, int localX, int loc
 		Vec3 mins = Vec3((float)localX + worldOffset.x, (float)localY + worldOffset.y, (float)localZ + worldOffset.z);
 		Vec3 maxs((float)localX + 1.f + worldOffset.x, (float)localY + 1.f + worldOffset.y, (float)localZ + 1.f + worldOffset.z);
 
-		bool shouldApplyHSR = !m_world->m_debugDisableHSR;
+		bool shouldApplyHSR = (m_world == nullptr) || !m_world->m_debugDisableHSR;
 
 		// +x face (East)
 		if (!shouldApplyHSR || !BlockDef::IsBlockTypeOpaque(blockIter.GetEastNeighbour().GetBlock()->GetTypeID()))
@@ -686,8 +1031,8 @@ Rgba8 Chunk::GetFaceColor(const BlockIterator& blockIterator)
 	}
 	else
 	{
-		color.r = unsigned char(RangeMap(block->GetOutdoorLightInfluence(), 0.f, 15.f, 0.f, 255.f));
-		color.g = unsigned char(RangeMap(block->GetIndoorLightInfluence(), 0.f, 15.f, 0.f, 255.f));
+		color.r = static_cast<unsigned char>(RangeMap(block->GetOutdoorLightInfluence(), 0.f, 15.f, 0.f, 255.f));
+		color.g = static_cast<unsigned char>(RangeMap(block->GetIndoorLightInfluence(), 0.f, 15.f, 0.f, 255.f));
 		color.b = 127;
 		color.a = 255;
 	}
@@ -713,31 +1058,13 @@ void Chunk::InitializeLighting()
 		}
 	}
 
-	//make blocks as sky which are in direct line of sight of the sky
-	for (int y = 0; y < CHUNK_SIZE_Y; y++)
+	//generated chunks got their sky flags and outdoor light in the light stage; loaded ones get them here
+	if (!m_hasSkyLight)
 	{
-		for (int x = 0; x < CHUNK_SIZE_X; x++)
-		{
-			int z = CHUNK_MAX_Z;
-			int blockIndex = GetBlockIndexFromLocalCoords(IntVec3(x, y, z));
-			Block* block = &m_blocks[blockIndex];
-			if (block)
-			{
-				while (z >= 0 && !BlockDef::IsBlockTypeOpaque(block->GetTypeID()))
-				{
-					block->SetIsBlockSky(true);
-					z--;
-					if (z >= 0)
-					{
-						blockIndex = GetBlockIndexFromLocalCoords(IntVec3(x, y, z));
-						block = &m_blocks[blockIndex];
-					}
-				}
-			}
-		}
+		ComputeSkyLight();
 	}
 
-	//set each sky blocks outdoor lighting influence to max and dirty it's neighboring blocks
+	//dirty the neighbors of each sky block
 	for (int y = 0; y < CHUNK_SIZE_Y; y++)
 	{
 		for (int x = 0; x < CHUNK_SIZE_X; x++)
@@ -749,8 +1076,6 @@ void Chunk::InitializeLighting()
 			{
 				while (z>= 0 && !BlockDef::IsBlockTypeOpaque(block->GetTypeID()))
 				{
-					block->SetOutdoorLightInfluence(15);
-
 					BlockIterator blockIter( this, blockIndex );
 					m_world->MarkLightingDirtyIfNotSkyAndNotOpaque(blockIter.GetNorthNeighbour());
 					m_world->MarkLightingDirtyIfNotSkyAndNotOpaque(blockIter.GetEastNeighbour());
@@ -779,6 +1104,30 @@ void Chunk::InitializeLighting()
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Flags the blocks each column sees the sky through and gives them full outdoor light. Only touches this chunk's blocks
+// and needs no world, so the light stage runs it on a worker; InitializeLighting spreads the light to neighbors later.
+void Chunk::ComputeSkyLight()
+{
+	//make blocks as sky which are in direct line of sight of the sky
+	for (int y = 0; y < CHUNK_SIZE_Y; y++)
+	{
+		for (int x = 0; x < CHUNK_SIZE_X; x++)
+		{
+			for (int z = CHUNK_MAX_Z; z >= 0; z--)
+			{
+				Block& block = m_blocks[GetBlockIndexFromLocalCoords(IntVec3(x, y, z))];
+				if (BlockDef::IsBlockTypeOpaque(block.GetTypeID()))
+				{
+					break;
+				}
+				block.SetIsBlockSky(true);
+				block.SetOutdoorLightInfluence(15);
+			}
+		}
+	}
+	m_hasSkyLight = true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::DigBlock(const BlockIterator& blockIter)
 {
 	m_isChunkDirty = true;
@@ -799,99 +1148,141 @@ void Chunk::PlaceBlock(const BlockIterator& blockIter)
 	ProcessLightingForAddedBlock(blockIter);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
-void Chunk::SpawnBlockTemplate(std::string const& templateName, IntVec3 const& templateLocalCoords)
+// Stamps the template's precompiled runs with its origin one block above templateLocalCoords. The template's layers are
+// clipped to the chunk's height once; if its bounds fit inside the chunk's columns every run is copied straight into the
+// block array, otherwise each run is clipped in x and the rest of it is appended to out_spilledWritesByChunk under the
+// chunk it lands in.
+void Chunk::SpawnBlockTemplate(BlockTemplate const& blockTemplate, IntVec3 const& templateLocalCoords, PendingBlockWritesByChunk& out_spilledWritesByChunk)
 {
 	IntVec3 placementCoords = templateLocalCoords;
 	placementCoords.z += 1;
 
-	BlockTemplate const* blockTemplate = BlockTemplate::GetBlockTemplateByName(templateName.c_str());
-	GUARANTEE_OR_DIE(blockTemplate != nullptr, Stringf("No such block templated named %s", templateName.c_str()));
-	for (int i = 0; i < blockTemplate->m_blockTemplateEntries.size(); i++)
+	int firstRunIndex = blockTemplate.GetFirstRunInLayer(-placementCoords.z);
+	int endRunIndex = blockTemplate.GetFirstRunInLayer(CHUNK_SIZE_Z - placementCoords.z);
+	if (firstRunIndex >= endRunIndex)
 	{
-		BlockTemplateEntry const& blockToSpawn = blockTemplate->m_blockTemplateEntries[i];
-		IntVec3 blockLocalCoords = placementCoords + blockToSpawn.m_offset;
-		SetBlockTypeID(blockLocalCoords, blockToSpawn.m_blockType);
+		return;
 	}
+
+	IntVec3 boundsLocalMins = placementCoords + blockTemplate.m_boundsMins;
+	IntVec3 boundsLocalMaxs = placementCoords + blockTemplate.m_boundsMaxs;
+	bool isInsideChunkColumns = boundsLocalMins.x >= 0 && boundsLocalMins.y >= 0 && boundsLocalMaxs.x <= CHUNK_MAX_X && boundsLocalMaxs.y <= CHUNK_MAX_Y;
+
+	for (int runIndex = firstRunIndex; runIndex < endRunIndex; runIndex++)
+	{
+		BlockTemplateRun const& run = blockTemplate.m_runs[runIndex];
+		IntVec3 runLocalStart = placementCoords + run.m_start;
+		int runLocalEndX = runLocalStart.x + run.m_length;
+
+		int inChunkStartX = runLocalStart.x;
+		int inChunkEndX = runLocalEndX;
+		if (!isInsideChunkColumns)
+		{
+			bool isRowInChunk = runLocalStart.y >= 0 && runLocalStart.y <= CHUNK_MAX_Y;
+			inChunkStartX = isRowInChunk ? std::max(runLocalStart.x, 0) : runLocalEndX;
+			inChunkEndX = isRowInChunk ? std::min(runLocalEndX, CHUNK_SIZE_X) : runLocalEndX;
+		}
+
+		if (inChunkStartX < inChunkEndX)
+		{
+			Block* rowBlocks = &m_blocks[GetBlockIndex(0, runLocalStart.y, runLocalStart.z)];
+			for (int localX = inChunkStartX; localX < inChunkEndX; localX++)
+			{
+				rowBlocks[localX].SetTypeID(run.m_blockType);
+			}
+			m_isChunkDirty = true;
+		}
+
+		if (isInsideChunkColumns || m_pendingBlockWrites == nullptr)
+		{
+			continue;
+		}
+
+		for (int localX = runLocalStart.x; localX < runLocalEndX; localX++)
+		{
+			if (localX >= inChunkStartX && localX < inChunkEndX)
+			{
+				continue;
+			}
+
+			IntVec3 globalCoords = GetGlobalCoordsForLocalCoords(IntVec3(localX, runLocalStart.y, runLocalStart.z));
+			IntVec2 targetChunkCoords(globalCoords.x >> CHUNK_BITS_X, globalCoords.y >> CHUNK_BITS_Y);
+			PendingBlockWrite spilledWrite;
+			spilledWrite.m_blockIndex = static_cast<uint16_t>(GetBlockIndex(globalCoords.x & CHUNK_MAX_X, globalCoords.y & CHUNK_MAX_Y, globalCoords.z));
+			spilledWrite.m_blockType = run.m_blockType;
+			out_spilledWritesByChunk[targetChunkCoords].push_back(spilledWrite);
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Writes the blocks of the neighbors' structures this chunk does not hold yet. The records stay in the store: until this
+// chunk is saved it is regenerated when it comes back into range and needs them again.
+// onlyIntoAir keeps them from replacing anything in a chunk that was already finished (loaded or active).
+// Returns true if any block changed.
+bool Chunk::ApplyPendingBlockWrites(bool onlyIntoAir)
+{
+	std::vector<PendingBlockWrite> pendingWrites;
+	if (m_pendingBlockWrites == nullptr || !m_pendingBlockWrites->CopyWrites(m_chunkCoords, m_appliedSpillSources, pendingWrites))
+	{
+		return false;
+	}
+
+	static BlockDefID air = BlockDef::GetBlockDefIDByName("air");
+	bool didChangeBlocks = false;
+	for (int writeIndex = 0; writeIndex < (int)pendingWrites.size(); writeIndex++)
+	{
+		PendingBlockWrite const& pendingWrite = pendingWrites[writeIndex];
+		Block& block = m_blocks[pendingWrite.m_blockIndex];
+		if (onlyIntoAir && block.GetTypeID() != air)
+		{
+			continue;
+		}
+		block.SetTypeID(pendingWrite.m_blockType);
+		didChangeBlocks = true;
+	}
+
+	if (didChangeBlocks)
+	{
+		m_isChunkDirty = true;
+	}
+	return didChangeBlocks;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::AddCaves(unsigned int worldCaveSeed)
 {
-	//Set various cave generation constants
-  	constexpr float CHANCE_FOR_CAVE_TO_START_IN_A_CHUNK = 0.01f;
-  	constexpr float CAVE_MAX_DISTANCE_BLOCKS = 200.f;
-  	constexpr float CAVE_STEP_LENGTH = 10.f;
-  	constexpr float CAVE_MAX_TURN_DEGREES = 30.f;
-  	constexpr float CAVE_MAX_DIVE_DEGREES = 10.f;
-  	constexpr int   MAX_CAVE_STEPS = 50;
-  	
-  	//Calculate how big of a search area we will need to check chunks in order to detect for caves
-  	constexpr int CHUNK_WIDTH = (CHUNK_SIZE_X < CHUNK_SIZE_Y ? CHUNK_SIZE_X : CHUNK_SIZE_Y);
-  	constexpr int CAVE_SEARCH_RADIUS = 1 + int(CAVE_MAX_DISTANCE_BLOCKS / CHUNK_WIDTH);
-  
-  	//Search all chunks in a large rectangular region around us for possible cave start locations
-  	
-  	IntVec2 chunkSearchMins = m_chunkCoords - IntVec2((CAVE_SEARCH_RADIUS), (CAVE_SEARCH_RADIUS));
-  	IntVec2 chunkSearchMaxs = m_chunkCoords + IntVec2(CAVE_SEARCH_RADIUS, CAVE_SEARCH_RADIUS);
-  	for (int chunkY = chunkSearchMins.y; chunkY <= chunkSearchMaxs.y; chunkY++)
-  	{
-  		for (int chunkX = chunkSearchMins.x; chunkX <= chunkSearchMaxs.x; chunkX++)
-  		{
-  			float caveOriginationNoise = Get2dNoiseZeroToOne(chunkX, chunkY, worldCaveSeed);
-  			if (caveOriginationNoise < CHANCE_FOR_CAVE_TO_START_IN_A_CHUNK)
-  			{
-  				//make a note that "a cave definitely starts somewhere in a chunk"
-  				m_nearbyCaves.push_back( CaveInfo(IntVec2(chunkX, chunkY)) );
-  			}
-  		}
-  	}
-  
-  	//For each cave originating nearby, determine its eaxct start location, then start wandering
-  	for (int i = 0; i < int(m_nearbyCaves.size()); i++)
-  	{
-  		//Create a (mostly) unique seed for THIS CAVE, and create a private RNG based on that seed
-  		CaveInfo& cave = m_nearbyCaves[i];   //ToDo#come up with a seed that is consistent for this cave
-  		unsigned int seedForThisCave = Get2dNoiseUint(cave.m_startChunkCoords.x, cave.m_startChunkCoords.y, worldCaveSeed + i);
-  		RandomNumberGenerator caveRng(seedForThisCave);
-  		
-  		//Pick a random starting position withing the cave's starting chunk (which is prolly not me)
-  		AABB3 startChunkBounds = GetChunkBoundsForChunkCoords(cave.m_startChunkCoords);
-  		Vec3 crawlWorldPosition;
-  		cave.m_startWorldPos.x = caveRng.RollRandomFloatInRange(startChunkBounds.m_mins.x, startChunkBounds.m_maxs.x);
-  		cave.m_startWorldPos.y = caveRng.RollRandomFloatInRange(startChunkBounds.m_mins.y, startChunkBounds.m_maxs.y);
-  		cave.m_startWorldPos.z = caveRng.RollRandomFloatInRange(30.f, 50.f);
-  		EulerAngles crawlOrientation;
-  		crawlOrientation.m_yawDegrees = caveRng.RollRandomFloatInRange(0.f, 360.f);
-  		crawlOrientation.m_pitchDegrees = 0.f;
-  		crawlOrientation.m_rollDegrees = 0.f;
- 
-  
-  		//Note the starting pos, then start crawling
-  		Vec3 crawlWorldPos = cave.m_startWorldPos;
-  		for (int crawlStep = 0; crawlStep < 25; crawlStep++)
-  		{
-  			//Vec3 forwardDisplacement = Vec3(Vec2::MakeFromPolarDegrees(yawDegrees, CAVE_STEP_LENGTH));
-  			Vec3 forwardDisplacement = CAVE_STEP_LENGTH * crawlOrientation.GetForwardVector();
-  			crawlWorldPosition += forwardDisplacement;
-			crawlOrientation.m_yawDegrees += caveRng.RollRandomFloatInRange(-CAVE_MAX_TURN_DEGREES, CAVE_MAX_TURN_DEGREES);
-			float noise = Compute1dPerlinNoise(float(crawlStep), 5.f, 3, 0.5f, 2.f, true, seedForThisCave + 5);
-			crawlOrientation.m_pitchDegrees = RangeMapClamped(noise, -1.f, 1.f, -89.f, 89.f);
-  			cave.m_caveNodePositions.push_back(crawlWorldPosition);
-  		}
-  	}
+	PROFILE_SCOPE("Chunk::AddCaves");
 
+	//Each cave's path is crawled once per world and shared through the cave cache, so this chunk only has to carve
+	std::vector<IntVec2> caveStartChunkCoords;
+	CaveCache::FindCaveStartChunksNear(m_chunkCoords, worldCaveSeed, caveStartChunkCoords);
+	m_nearbyCaves.reserve(caveStartChunkCoords.size());
+	for (int caveIndex = 0; caveIndex < (int)caveStartChunkCoords.size(); caveIndex++)
+	{
+		if (m_caveCache != nullptr && m_caveCache->GetWorldCaveSeed() == worldCaveSeed)
+		{
+			m_nearbyCaves.push_back(m_caveCache->GetCave(caveStartChunkCoords[caveIndex]));
+		}
+		else
+		{
+			std::shared_ptr<CaveInfo> cave = std::make_shared<CaveInfo>(caveStartChunkCoords[caveIndex]);
+			CaveCache::ComputeCave(worldCaveSeed, *cave);
+			m_nearbyCaves.push_back(cave);
+		}
+	}
 
+	//Only the segments each cave indexed under this chunk can reach it
 	for (int caveIndex = 0; caveIndex < m_nearbyCaves.size(); caveIndex++)
 	{
-		for (int caveNodeIndex = 0; caveNodeIndex < m_nearbyCaves[caveIndex].m_caveNodePositions.size(); caveNodeIndex++)
+		CaveInfo const& cave = *m_nearbyCaves[caveIndex];
+		int numSegments = (int)cave.m_segmentsByChunk.size();
+		for (int segmentIndex = CaveCache::FindFirstSegmentInChunk(cave, m_chunkCoords); segmentIndex < numSegments; segmentIndex++)
 		{
-			if (caveNodeIndex == 0)
+			CaveSegment const& segment = cave.m_segmentsByChunk[segmentIndex];
+			if (!(segment.m_chunkCoords == m_chunkCoords))
 			{
-				CarveCapsule3D(m_nearbyCaves[caveIndex].m_startWorldPos, m_nearbyCaves[caveIndex].m_caveNodePositions[caveNodeIndex], 5.f);
-			}
-			else
-			{
-				CarveCapsule3D(m_nearbyCaves[caveIndex].m_caveNodePositions[caveNodeIndex - 1], m_nearbyCaves[caveIndex].m_caveNodePositions[caveNodeIndex], 5.f);
+				break;
 			}
+			CarveCapsule3D(segment.m_start, segment.m_end, CaveCache::CAVE_RADIUS);
 		}
 	}
 	//CarveAABB3D(Vec3(10.f, 10.f, 20.f), Vec3(12.f, 7.f, 4.f));
@@ -911,8 +1302,11 @@ void Chunk::AddCaves(unsigned int worldCaveSeed)
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::ForceCreateWorldFolder()
 {
-	std::string command = Stringf("mkdir Saves\\World_%u", m_worldSeed);
-	system(command.c_str());
+	//std::filesystem instead of shelling out to mkdir, so the headless build can save on Linux as well
+	std::string folderPath = Stringf("Saves/World_%u", m_worldSeed);
+	std::error_code errorCode;
+	std::filesystem::create_directories(folderPath, errorCode);
+	s_numFolderCreates++;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::CarveAABB3D(Vec3 worldCenter, Vec3 halfDimensions)
@@ -1026,55 +1420,53 @@ Vec3 Chunk::GetChunkCenter()
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 int Chunk::CalculateGroundZHeightForGlobalXY(float globalX, float globalY)
 {
-	int riverDepth = 6;
-	int oceanHeightZ = CHUNK_SIZE_Z / 2;
-	int lowestOceanFloorZ = CHUNK_SIZE_Z / 4;
-	int maxOceanLowering = oceanHeightZ - lowestOceanFloorZ;
-
-	int   groundHeightZ = 0;
-	float oceanness = 0.f;
-	float hilliness = 0.f;
-	
-	oceanness = 0.5f + 0.5f * Compute2dPerlinNoise(globalX, globalY, 800.f, 7, 0.5f, 2.f, true, m_worldSeed + 3);
-	oceanness = SmoothStep3(SmoothStep3(oceanness));
-	hilliness = 0.5f + 0.5f * Compute2dPerlinNoise(globalX, globalY, 400.f, 5, 0.5f, 2.f, true, m_worldSeed + 4);
-	hilliness = SmoothStep3(SmoothStep3(hilliness));		//smooth step makes the extreme more extremey.
-
-	//calculate terrain height, considering oceanness(lowers land and hilliness(exaggerates height changes))
-	int mountainMaxHeight = CHUNK_SIZE_Z - oceanHeightZ + riverDepth;
-	float mountainHeight = hilliness * float(mountainMaxHeight);
-	float heightNoise = fabsf(Compute2dPerlinNoise(globalX, globalY, 200.f, 7, 0.5f, 2.f, true, m_worldSeed));
-	groundHeightZ = oceanHeightZ - riverDepth + int(mountainHeight * heightNoise);
-
-	//Lower terrain where oceanness is high(and do the transition or lerp)
-	float oceanLoweringEffectStrength = RangeMapClamped(oceanness, 0.5f, 1.f, 0.f, 1.f);
-	int oceanLoweringAmount = int(oceanLoweringEffectStrength * float(maxOceanLowering));
-	groundHeightZ -= oceanLoweringAmount;
+	if (m_columnCache != nullptr && globalX == floorf(globalX) && globalY == floorf(globalY))
+	{
+		return m_columnCache->GetColumn(static_cast<int>(globalX), static_cast<int>(globalY)).m_groundHeightZ;
+	}
+	return ColumnCache::ComputeGroundHeightZ(globalX, globalY, m_worldSeed);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::shared_ptr<ChunkColumns const> Chunk::GetChunkColumns()
+{
+	if (m_columnCache != nullptr)
+	{
+		return m_columnCache->GetChunkColumns(m_chunkCoords);
+	}
 
-	return groundHeightZ;
+	ColumnCacheConfig columnConfig;
+	columnConfig.m_worldSeed = m_worldSeed;
+	std::shared_ptr<ChunkColumns> chunkColumns = std::make_shared<ChunkColumns>();
+	ColumnCache::ComputeChunkColumns(m_chunkCoords, columnConfig, *chunkColumns);
+	return chunkColumns;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::AddTrees()
 {
+	PROFILE_SCOPE("Chunk::AddTrees");
 	//int maxSandDepth = 8;
 	int oceanHeightZ = CHUNK_SIZE_Z / 2;
 	std::vector<IntVec3> treeSpawnLocalCoordsList;
 
-	//Create a larger grid of tree noise that extends into neighbors
-	constexpr int MAX_TREE_RADIUS = 3;
-	constexpr int TREE_GRID_SIZE_X = CHUNK_SIZE_X + (MAX_TREE_RADIUS * 2) + 1 + 1;
-	constexpr int TREE_GRID_SIZE_Y = CHUNK_SIZE_Y + (MAX_TREE_RADIUS * 2) + 1 + 1;
+	//Only trees rooted in this chunk are decided here; SpawnBlockTemplate hands the parts that reach into neighbors to the
+	//pending block writes, so the grid only needs the one-block border the local maximum test looks at
+	constexpr int TREE_GRID_SIZE_X = CHUNK_SIZE_X + 1 + 1;
+	constexpr int TREE_GRID_SIZE_Y = CHUNK_SIZE_Y + 1 + 1;
 	constexpr int TREE_GRID_COUNT = TREE_GRID_SIZE_X * TREE_GRID_SIZE_Y;
 	float treeNoise[TREE_GRID_COUNT] = {};
 
+	//Forestness has always been sampled this far from the tree cell it gates; kept so existing worlds keep their forests
+	constexpr int FORESTNESS_OFFSET_X = CHUNK_SIZE_X + 5;
+	constexpr int FORESTNESS_OFFSET_Y = CHUNK_SIZE_Y + 5;
+
+	int chunkMinsGlobalX = m_chunkCoords.x * CHUNK_SIZE_X;
+	int chunkMinsGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y;
+	int treeSpaceMinsGlobalX = chunkMinsGlobalX - 1;
+	int treeSpaceMinsGlobalY = chunkMinsGlobalY - 1;
 	for (int treeY = 0; treeY < TREE_GRID_SIZE_Y; treeY++)
 	{
 		for (int treeX = 0; treeX < TREE_GRID_SIZE_X; treeX++)
 		{
-			int chunkMinsGlobalX = m_chunkCoords.x * CHUNK_SIZE_X;
-			int chunkMinsGlobalY = m_chunkCoords.y * CHUNK_SIZE_Y;
-			int treeSpaceMinsGlobalX = chunkMinsGlobalX - MAX_TREE_RADIUS - 1;
-			int treeSpaceMinsGlobalY = chunkMinsGlobalY - MAX_TREE_RADIUS - 1;
 			int globalX = treeSpaceMinsGlobalX + treeX;
 			int globalY = treeSpaceMinsGlobalY + treeY;
 			float treeNoiseHere = Get2dNoiseZeroToOne(globalX, globalY, m_worldSeed + 5);
@@ -1090,8 +1482,8 @@ void Chunk::AddTrees()
 	{
 		for (int treeX = 1; treeX < TREE_GRID_SIZE_X - 1; treeX++)
 		{
-			int globalX = (m_chunkCoords.x * CHUNK_SIZE_X) + treeX - TREE_GRID_SIZE_X - 1;
-			int globalY = (m_chunkCoords.y * CHUNK_SIZE_Y) + treeY - TREE_GRID_SIZE_Y - 1;
+			int globalX = treeSpaceMinsGlobalX + treeX - FORESTNESS_OFFSET_X;
+			int globalY = treeSpaceMinsGlobalY + treeY - FORESTNESS_OFFSET_Y;
 			float forestness = 0.5f + 0.5f * Compute2dPerlinNoise(static_cast<float>(globalX), static_cast<float>(globalY), 200.f, 10, 0.5f, 2.f, true, m_worldSeed + 6);
 			float minimumTreeNoiseToSpawnHere = RangeMapClamped(forestness, 0.75f, 1.f, 1.00f, 0.5f);
 			int myTreeNoiseIndex = treeX + (treeY * TREE_GRID_SIZE_X);
@@ -1131,8 +1523,8 @@ void Chunk::AddTrees()
 			}
 			if (isHighest)
 			{
-				int localX = treeX - MAX_TREE_RADIUS - 1;  //eg treeX = 2 means localX = -1.
-				int localY = treeY - MAX_TREE_RADIUS - 1;
+				int localX = treeX - 1;
+				int localY = treeY - 1;
 				treeLocalXYs.push_back(IntVec2(localX, localY));
 			}
 		}
@@ -1146,12 +1538,25 @@ void Chunk::AddTrees()
 		float globalY = m_worldBounds.m_mins.y + float(localY);
 
 		int groundHeight = CalculateGroundZHeightForGlobalXY(globalX, globalY);
+		if (groundHeight <= oceanHeightZ || groundHeight > CHUNK_MAX_Z)
+		{
+			continue;
+		}
 
-		if (groundHeight > oceanHeightZ)
+		//The carve stage ran first, so a cave may have opened the noise ground under the root; no floating trees
+		if (!BlockDef::IsBlockTypeOpaque(m_blocks[GetBlockIndex(localX, localY, groundHeight)].GetTypeID()))
 		{
-			treeSpawnLocalCoordsList.push_back(IntVec3(localX, localY, groundHeight));
+			continue;
 		}
+		treeSpawnLocalCoordsList.push_back(IntVec3(localX, localY, groundHeight));
 	}
+
+	//Templates are compiled once at startup and never change, so the name lookup is paid once
+	static BlockTemplate const* oakTree = BlockTemplate::GetBlockTemplateByName("oak_tree");
+	GUARANTEE_OR_DIE(oakTree != nullptr, "No such block template named oak_tree");
+
+	//Blocks that land in other chunks are recorded for those chunks instead of being dropped
+	PendingBlockWritesByChunk spilledWritesByChunk;
 	for (int i = 0; i < int(treeSpawnLocalCoordsList.size()); i++)
 	{
 		
@@ -1170,19 +1575,140 @@ void Chunk::AddTrees()
 // 		// determine the type of tree to spawn based on the temperature and humidity
 // 		if (temperature < 0.4f) // for low temperatures, spawn spruce trees
 // 		{
-// 			SpawnBlockTemplate("spruce_tree", localSpawnPos);
+// 			SpawnBlockTemplate(*spruceTree, localSpawnPos);
 // 		}
 // 		else if (humidity < 0.65f) // if there is sand (sandDepth > 0), it is a desert, spawn cacti
 // 		{
-// 			SpawnBlockTemplate("cactus", localSpawnPos);
+// 			SpawnBlockTemplate(*cactus, localSpawnPos);
 // 		}
 		
-		SpawnBlockTemplate("oak_tree", localSpawnPos);
+		SpawnBlockTemplate(*oakTree, localSpawnPos, spilledWritesByChunk);
+
+	}
 
+	if (m_pendingBlockWrites != nullptr)
+	{
+		m_pendingBlockWrites->SetWrites(m_chunkCoords, spilledWritesByChunk);
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void Chunk::GenerateCaves()
+{
+	std::vector<IntVec2> caveStartCoords;
+	FindCaveStartMaxima(caveStartCoords);
+
+	std::vector<IntVec3> cavePoints;
+	cavePoints.reserve(m_caveNodeAmount + 1);
+	for (int caveIndex = 0; caveIndex < (int)caveStartCoords.size(); caveIndex++)
+	{
+		cavePoints.clear();
+		GetCavePath(caveStartCoords[caveIndex], cavePoints);
+		CarveCavePath(cavePoints);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Writes the maximum of values[(i - radius) .. (i + radius - 1)] for numOutputs consecutive positions i starting at
+// firstOutput, reading and writing with the given strides so the same pass filters rows and columns of a flat grid.
+// Keeps a queue of sample indices with decreasing values, so each output costs O(1) amortized whatever the radius.
+static void ComputeSlidingWindowMaxima(float const* values, int valueStride, int radius, int firstOutput, int numOutputs, float* out_maxima, int outputStride, std::vector<int>& queueScratch)
+{
+	queueScratch.resize(numOutputs + 2 * radius);
+	int queueHead = 0;
+	int queueTail = 0;
+	int nextValueIndex = firstOutput - radius;
+	for (int outputIndex = 0; outputIndex < numOutputs; outputIndex++)
+	{
+		int windowCenter = firstOutput + outputIndex;
+		for (; nextValueIndex <= windowCenter + radius - 1; nextValueIndex++)
+		{
+			float value = values[nextValueIndex * valueStride];
+			while (queueTail > queueHead && values[queueScratch[queueTail - 1] * valueStride] <= value)
+			{
+				queueTail--;
+			}
+			queueScratch[queueTail++] = nextValueIndex;
+		}
+		while (queueScratch[queueHead] < windowCenter - radius)
+		{
+			queueHead++;
+		}
+		out_maxima[outputIndex * outputStride] = values[queueScratch[queueHead] * valueStride];
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same cave starts, in the same order, as FindCaveStartMaximaReference: chunk coords within m_caveCheckRadius whose start
+// noise is strictly greater than every other value in the window [coords - radius, coords + radius - 1].
+// The noise lives in a dense grid covering only what those windows read, and the window maxima come from a row pass and
+// a column pass of sliding maxima, so no candidate scans its whole window unless it is already the window maximum.
+void Chunk::FindCaveStartMaxima(std::vector<IntVec2>& out_caveStartCoords)
+{
+	int radius = m_caveCheckRadius;
+	if (radius <= 0)
+	{
+		return;
+	}
+	int diameter = radius * 2;
+	int fieldWidth = 4 * radius - 1;
+	IntVec2 fieldMins = m_chunkCoords - IntVec2(diameter, diameter);
+
+	std::vector<float> noiseField(fieldWidth * fieldWidth);
+	for (int fieldY = 0; fieldY < fieldWidth; fieldY++)
+	{
+		for (int fieldX = 0; fieldX < fieldWidth; fieldX++)
+		{
+			IntVec2 resultingCoords = fieldMins + IntVec2(fieldX, fieldY);
+			noiseField[fieldX + fieldY * fieldWidth] = 0.5f + 0.5f * Compute2dPerlinNoise((float)resultingCoords.x, (float)resultingCoords.y, 0.35f, 7, 0.9f, 20.0f, true, m_worldSeed + 25);
+		}
+	}
+
+	//Candidates sit at field offsets [radius, 3 * radius - 1] on both axes
+	std::vector<int> queueScratch;
+	std::vector<float> rowMaxima(fieldWidth * diameter);
+	for (int fieldY = 0; fieldY < fieldWidth; fieldY++)
+	{
+		ComputeSlidingWindowMaxima(&noiseField[fieldY * fieldWidth], 1, radius, radius, diameter, &rowMaxima[fieldY * diameter], 1, queueScratch);
+	}
+	std::vector<float> windowMaxima(diameter * diameter);
+	for (int candidateX = 0; candidateX < diameter; candidateX++)
+	{
+		ComputeSlidingWindowMaxima(&rowMaxima[candidateX], diameter, radius, radius, diameter, &windowMaxima[candidateX], diameter, queueScratch);
+	}
+
+	for (int candidateY = 0; candidateY < diameter; candidateY++)
+	{
+		for (int candidateX = 0; candidateX < diameter; candidateX++)
+		{
+			int fieldX = candidateX + radius;
+			int fieldY = candidateY + radius;
+			float candidateNoise = noiseField[fieldX + fieldY * fieldWidth];
+			if (candidateNoise < windowMaxima[candidateX + candidateY * diameter])
+			{
+				continue;
+			}
+
+			//It holds the window maximum; it only counts if no other sample ties it
+			bool isStrictMaxima = true;
+			for (int windowY = fieldY - radius; windowY < fieldY + radius && isStrictMaxima; windowY++)
+			{
+				for (int windowX = fieldX - radius; windowX < fieldX + radius; windowX++)
+				{
+					if ((windowX != fieldX || windowY != fieldY) && noiseField[windowX + windowY * fieldWidth] >= candidateNoise)
+					{
+						isStrictMaxima = false;
+						break;
+					}
+				}
+			}
+			if (isStrictMaxima)
+			{
+				out_caveStartCoords.push_back(fieldMins + IntVec2(fieldX, fieldY));
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// The original std::map path, kept so BenchmarkCaveStarts can time and check FindCaveStartMaxima against it
+void Chunk::FindCaveStartMaximaReference(std::vector<IntVec2>& out_caveStartCoords)
 {
 	std::map<IntVec2, float> startPerlinNoise;
 	GetCavesStartPerlinNoise(startPerlinNoise);
@@ -1200,12 +1726,7 @@ void Chunk::GenerateCaves()
 			bool isCaveMaxima = AreCoordsConsideredLocalMaxima(resultingCoords, m_caveCheckRadius, startPerlinNoise);
 			if (isCaveMaxima)
 			{
-				std::vector<IntVec3> cavePoints;
-				cavePoints.reserve(m_caveNodeAmount);
-
-				GetCavePath(resultingCoords, cavePoints);
-				CarveCavePath(cavePoints);
-
+				out_caveStartCoords.push_back(resultingCoords);
 			}
 
 		}
@@ -1296,9 +1817,11 @@ void Chunk::CarveCavePath(std::vector<IntVec3>& cavePoints)
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs on a generation worker: only this chunk's blocks are written, with no neighbor, lighting or world access.
+// Points near a chunk border carve their share here and the rest when each neighbor walks the same cave path.
+// Sky light and glowstone light come from the light stage and InitializeLighting, like any other generated block.
 void Chunk::CarveBlockInRadius(Vec3 const& originPos, IntVec3 const& localCoords, float radius, bool replaceWithDirt, bool placeLampInMiddle)
 {
-
 	int radiusAsInt = RoundDownToInt(radius);
 	int diameter = radiusAsInt * 2;
 	float radiusSqr = radius * radius;
@@ -1307,8 +1830,9 @@ void Chunk::CarveBlockInRadius(Vec3 const& originPos, IntVec3 const& localCoords
 	IntVec3 startingCoords = localCoords - IntVec3(radiusAsInt, radiusAsInt, radiusAsInt);
 	
 	//BlockDefID water = BlockDef::GetBlockDefIDByName("water");
-	BlockDefID lamp = BlockDef::GetBlockDefIDByName("glowstone");
-	BlockDefID dirt = BlockDef::GetBlockDefIDByName("dirt");
+	static BlockDefID air = BlockDef::GetBlockDefIDByName("air");
+	static BlockDefID lamp = BlockDef::GetBlockDefIDByName("glowstone");
+	static BlockDefID dirt = BlockDef::GetBlockDefIDByName("dirt");
 
 	for (int zOffset = 0; zOffset < diameter; zOffset++) {
 		for (int yOffset = 0; yOffset < diameter; yOffset++) {
@@ -1316,40 +1840,31 @@ void Chunk::CarveBlockInRadius(Vec3 const& originPos, IntVec3 const& localCoords
 
 				IntVec3 resultingCoords = startingCoords + IntVec3(xOffset, yOffset, zOffset);
 				if (resultingCoords.z <= 0) continue;
-
-				IntVec3 globalCoords = GetGlobalCoordsForLocalCoords(resultingCoords);
-
-
 				if (!AreLocalCoordsWithinChunk(resultingCoords)) continue;
 
-
-
+				IntVec3 globalCoords = GetGlobalCoordsForLocalCoords(resultingCoords);
 				Vec3 blockCenter = Vec3(globalCoords.x + 0.5f, globalCoords.y + 0.5f, globalCoords.z + 0.5f);
 				float distanceToBlock = GetDistanceSquared3D(blockCenter, originPos);
 
-				if (!AreLocalCoordsWithinChunk(resultingCoords)) continue;
-				
-				
-
 				int blockIndex = GetBlockIndexFromLocalCoords(IntVec3(resultingCoords));
 				Block& carvedBlock = m_blocks[blockIndex];
 
 				if (placeLampInMiddle && distanceToBlock == 0.f && resultingCoords.z < 64)
 				{
+					changedAnything = true;
 					carvedBlock.SetTypeID(lamp);
 				}
 				else if(distanceToBlock < radiusSqr)
 				{
-					if (carvedBlock.GetTypeID() != 0)
+					if (carvedBlock.GetTypeID() != air)
 					{
 						changedAnything = true;
-						BlockIterator blockIter = BlockIterator(this, blockIndex);
-						DigBlock(blockIter);
+						carvedBlock.SetTypeID(air);
 					}
 				}
 				else if (replaceWithDirt)
 				{
-					if (carvedBlock.GetTypeID() != 0)
+					if (carvedBlock.GetTypeID() != air)
 					{
 						changedAnything = true;
 						carvedBlock.SetTypeID(dirt);
@@ -1362,10 +1877,6 @@ void Chunk::CarveBlockInRadius(Vec3 const& originPos, IntVec3 const& localCoords
 	if (changedAnything)
 	{
 		m_isChunkDirty = true;
-		if (m_northNeighbor) m_northNeighbor->m_isChunkDirty;
-		if (m_southNeighbor) m_southNeighbor->m_isChunkDirty;
-		if (m_eastNeighbor) m_eastNeighbor->m_isChunkDirty;
-		if (m_westNeighbor) m_westNeighbor->m_isChunkDirty;
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1424,22 +1935,65 @@ IntVec3 Chunk::GetGlobalCoordsForLocalCoords(IntVec3 const& localCoords)
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void ChunkGenerationJob::Execute()
 {
-	m_chunk->m_status = ACTIVATING_GENERATING;
-	m_chunk->Generateblocks();
+	PROFILE_SCOPE("ChunkGenerationJob::Execute");
+	JobTelemetry::OnJobStarted(JOB_TELEMETRY_GENERATION, m_timing);
+	if (m_stage == GENERATION_STAGE_TERRAIN && m_bandIndex == 0)
+	{
+		m_chunk->SetStatus(ACTIVATING_GENERATING);
+	}
+
+	if (m_numBands <= 1)
+	{
+		m_chunk->RunGenerationStage(m_stage);
+		m_completesStage = true;
+	}
+	else
+	{
+		m_completesStage = m_chunk->GenerateBlocksBand(m_bandIndex, m_numBands);
+	}
+
+	if (m_completesStage)
+	{
+		//Published last, so neighbors waiting on this stage see all of its blocks
+		m_chunk->m_numGenerationStagesDone = m_stage + 1;
+		if (m_stage == GENERATION_STAGE_LIGHT)
+		{
+			PerfCounters::Increment(PERF_COUNTER_CHUNKS_GENERATED);
+		}
+	}
+	JobTelemetry::OnJobFinished(JOB_TELEMETRY_GENERATION, m_timing);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void ChunkGenerationJob::OnFinished()
 {
-	m_chunk->m_status = ACTIVATING_GENERATE_COMPLETE;
+	//Only the band that ran the stage's last step may touch the chunk; it can be activated before the other bands are retrieved
+	if (m_completesStage && m_stage == GENERATION_STAGE_LIGHT)
+	{
+		m_chunk->SetStatus(ACTIVATING_GENERATE_COMPLETE);
+	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void ChunkDiskLoadJob::Execute()
 {
+	PROFILE_SCOPE("ChunkDiskLoadJob::Execute");
+	JobTelemetry::OnJobStarted(JOB_TELEMETRY_DISK_LOAD, m_timing);
 	
-	m_chunk->m_status = ChunkState::ACTIAVTING_QUEUED_LOAD;
+	m_chunk->SetStatus(ChunkState::ACTIAVTING_QUEUED_LOAD);
+	m_chunk->RecordLifecycleEvent(CHUNK_LIFECYCLE_JOB_STARTED);
 	m_loadingSuccessful = m_chunk->LoadBlocksFromFile();
+	if (m_loadingSuccessful)
+	{
+		PerfCounters::Increment(PERF_COUNTER_CHUNKS_LOADED);
+
+		//Structures of neighbors first decorated after this chunk was saved; they never replace saved blocks
+		if (m_chunk->ApplyPendingBlockWrites(true))
+		{
+			m_chunk->m_needsSaving = true;
+		}
+	}
+	JobTelemetry::OnJobFinished(JOB_TELEMETRY_DISK_LOAD, m_timing);
 	
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1448,7 +2002,7 @@ void ChunkDiskLoadJob::OnFinished()
 	if (m_loadingSuccessful)
 	{
 		
-			m_chunk->m_status = ChunkState::ACTIVATING_LOAD_COMPLETE;
+			m_chunk->SetStatus(ChunkState::ACTIVATING_LOAD_COMPLETE);
 		
 	}
 // 	else
@@ -1462,16 +2016,26 @@ void ChunkDiskLoadJob::OnFinished()
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void ChunkDiskSaveJob::Execute()
 {
+	PROFILE_SCOPE("ChunkDiskSaveJob::Execute");
+	JobTelemetry::OnJobStarted(JOB_TELEMETRY_DISK_SAVE, m_timing);
 	
-		m_chunk->m_status = ChunkState::DEACTIVATING_QUEUED_SAVE;
+		m_chunk->SetStatus(ChunkState::DEACTIVATING_QUEUED_SAVE);
 		m_chunk->SaveBlockToFile();
+		PerfCounters::Increment(PERF_COUNTER_CHUNKS_SAVED);
+
+		//The file now holds the blocks its neighbors' structures left, and a saved chunk is loaded rather than regenerated
+		if (m_chunk->m_pendingBlockWrites != nullptr)
+		{
+			m_chunk->m_pendingBlockWrites->OnChunkSaved(m_chunk->GetChunkCoordinates(), m_chunk->m_appliedSpillSources);
+		}
+		JobTelemetry::OnJobFinished(JOB_TELEMETRY_DISK_SAVE, m_timing);
 	
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void ChunkDiskSaveJob::OnFinished()
 {
 	
-		m_chunk->m_status = ChunkState::DEACTIVATING_SAVE_COMPLETE;
+		m_chunk->SetStatus(ChunkState::DEACTIVATING_SAVE_COMPLETE);
 	
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -7,12 +7,24 @@
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/IntVec3.hpp"
 #include "Engine/Core/JobSystem.hpp"
+#include "Game/ChunkLifecycle.hpp"
+#include "Game/JobTelemetry.hpp"
+#include "Game/PendingBlockWrites.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class VertexBuffer;
 class World;
 struct BlockIterator;
+struct ChunkColumns;
+class  OreVeinField;
+class  ColumnCache;
+class  CaveCache;
+struct ChunkMemoryUsage;
 class  BlockTemplate;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 constexpr int CHUNK_BITS_X = 4;
@@ -32,6 +44,13 @@ constexpr int CHUNK_BLOCKS_TOTAL = CHUNK_BLOCKS_PER_LAYER * CHUNK_SIZE_Z;
 
 constexpr int SEA_LEVEL = CHUNK_SIZE_Z / 2;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct CaveSegment
+{
+	IntVec2 m_chunkCoords;
+	Vec3	m_start;
+	Vec3	m_end;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 struct CaveInfo
 {
 	CaveInfo(IntVec2 chunkCoords)
@@ -40,6 +59,7 @@ struct CaveInfo
 	IntVec2 m_startChunkCoords;
 	Vec3    m_startWorldPos;
 	std::vector<IntVec3> m_caveNodePositions;
+	std::vector<CaveSegment> m_segmentsByChunk;		//each capsule segment once per chunk its bounds overlap, sorted by chunk coords
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 enum ChunkState
@@ -59,19 +79,41 @@ enum ChunkState
 	NUM_CHUNK_STATES
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+// A generated chunk runs one job per stage, in this order, while it is ACTIVATING_GENERATING
+enum ChunkGenerationStage
+{
+	GENERATION_STAGE_TERRAIN,			//ground, water, clouds and ores from the column noise
+	GENERATION_STAGE_CARVE,				//worm caves
+	GENERATION_STAGE_DECORATE,			//trees
+	GENERATION_STAGE_LIGHT,				//sky flags and outdoor light of the chunk's own columns
+	NUM_GENERATION_STAGES
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 class Chunk
 {
 public:
 	Chunk(World* world, IntVec2 const& chunkCoords);
+	Chunk(IntVec2 const& chunkCoords, unsigned int worldSeed);	//detached from any world, no GPU mesh; used by the benchmarks
 	~Chunk();
 
 	void			Update();
 	void			Render();
 	
 	void			Generateblocks();
+	void			RunGenerationStage(ChunkGenerationStage stage);
+	void			GenerateTerrain();
+	void			GenerateTerrainRows(ChunkColumns const& chunkColumns, OreVeinField const* oreVeins, int minLocalY, int maxLocalY);
+	void			PrepareGenerationBands(int numBands);
+	bool			GenerateBlocksBand(int bandIndex, int numBands);
+	unsigned int	GetOreSeed() const;
+	unsigned int	GetWorldCaveSeed() const;
+	static unsigned int	GetWorldCaveSeedForWorldSeed(unsigned int worldSeed);
 	void			RebuildMesh();
 	void			SetBlockType(int localX, int localY, int localZ, BlockDefID blockType);
 	void			SetBlockTypeID(IntVec3 const& localCoords, BlockDefID blockType);
+	void			FillColumnSpan(int localX, int localY, int minZ, int maxZ, BlockDefID blockType);
+	void			FillLayers(int minZ, int maxZ, BlockDefID blockType);
+	void			FillLayerRows(int minZ, int maxZ, int minLocalY, int maxLocalY, BlockDefID blockType);
 	void			InitializeVertexBuffer();
 	static bool		IsInBoundsLocal(int localX, int localY, int localZ);
 	static int		GetBlockIndex(int localX, int localY, int localZ);
@@ -105,17 +147,22 @@ public:
 	void			ProcessLightingForAddedBlock(const BlockIterator& blockIter);
 	Rgba8			GetFaceColor(const BlockIterator& blockIterator);
 	void			InitializeLighting();
+	void			ComputeSkyLight();
 	void			DigBlock(const BlockIterator& blockIter);
 	void			PlaceBlock(const BlockIterator& blockIter);
-	void			SpawnBlockTemplate(std::string const& name, IntVec3 const& localCoords);
+	void			SpawnBlockTemplate(BlockTemplate const& blockTemplate, IntVec3 const& localCoords, PendingBlockWritesByChunk& out_spilledWritesByChunk);
+	bool			ApplyPendingBlockWrites(bool onlyIntoAir);
 	void			AddCaves(unsigned int worldCaveSeed);
 	void			ForceCreateWorldFolder();
 	void			CarveAABB3D(Vec3 worldCenter, Vec3 halfDimensions);
 	void			CarveCapsule3D(Vec3 worldStart, Vec3 worldEnd, float radius);
 	Vec3			GetChunkCenter();
 	int				CalculateGroundZHeightForGlobalXY(float globalX, float globalY);
+	std::shared_ptr<ChunkColumns const> GetChunkColumns();
 	void			AddTrees();
 	void			GenerateCaves();
+	void			FindCaveStartMaxima(std::vector<IntVec2>& out_caveStartCoords);
+	void			FindCaveStartMaximaReference(std::vector<IntVec2>& out_caveStartCoords);
 	void			GetCavesStartPerlinNoise(std::map<IntVec2, float>& perlinNoiseHolder);
 	void			GetCavePath(IntVec2 const& coords, std::vector<IntVec3>& cavePoints);
 	void			CarveCavePath(std::vector<IntVec3>& cavePoints);
@@ -123,6 +170,10 @@ public:
 	bool			AreCoordsConsideredLocalMaxima(IntVec2 const& coords, int radius, std::map<IntVec2, float> const& perlinNoiseHolder) const;
 	bool			AreLocalCoordsWithinChunk(IntVec3 const& localCoords);
 	IntVec3			GetGlobalCoordsForLocalCoords(IntVec3 const& localCoords);
+	size_t			GetNearbyCavesBytes() const;
+	void			SetStatus(ChunkState newStatus);
+	void			RecordLifecycleEvent(ChunkLifecycleEvent lifecycleEvent);
+	void			GetMemoryUsage(ChunkMemoryUsage& out_usage) const;
 public:
 	IntVec2					m_chunkCoords = IntVec2(0, 0);
 	AABB3					m_worldBounds = AABB3::ZERO_TO_ONE;
@@ -131,65 +182,111 @@ public:
 	unsigned int			m_worldSeed = 0;
 	std::vector<Vertex_PCU> m_cpuMesh;
 	VertexBuffer*			m_gpuMeshVBO = nullptr;
+	size_t					m_gpuMeshBytes = 0;
 	bool					m_isChunkDirty = true;
 	bool					m_needsSaving = false;
 	World*					m_world = nullptr;
+	ColumnCache*			m_columnCache = nullptr;		//shared ground height and climate; nullptr computes them per call
+	CaveCache*				m_caveCache = nullptr;			//shared cave paths; nullptr crawls every nearby cave per chunk
+	PendingBlockWrites*		m_pendingBlockWrites = nullptr;	//structure blocks that spill into other chunks; nullptr drops them
 	Chunk*					m_northNeighbor = nullptr;
 	Chunk*					m_southNeighbor = nullptr;
 	Chunk*					m_eastNeighbor = nullptr;
 	Chunk*					m_westNeighbor = nullptr;
-	std::vector<CaveInfo>	m_nearbyCaves;
+	std::vector<std::shared_ptr<CaveInfo const>>	m_nearbyCaves;
 	std::atomic<ChunkState> m_status = MISSING;
+	double					m_lifecycleSeconds[NUM_CHUNK_LIFECYCLE_EVENTS] = {};	//first time each milestone was reached, 0 if never
+	bool					m_wasLoadedFromDisk = false;
+	uint8_t					m_appliedSpillSources = 0;		//neighbors whose structure blocks m_blocks holds (PendingBlockWrites::GetSourceBit)
+	bool					m_useOreVeins = true;			//clustered ore veins; false places each ore block independently
+	bool					m_useWormCaves = false;			//the carve stage also runs GenerateCaves' noise-path worm caves
+	std::atomic<int>		m_numGenerationBandsLeft = 0;	//row bands still running when generation is split across jobs
+	std::shared_ptr<ChunkColumns> m_bandColumns;			//columns the bands fill in, published to the column cache by the last band
+	std::shared_ptr<OreVeinField const> m_bandOreVeins;	//vein lattices every band reads, built once before the bands are queued
+	std::atomic<int>		m_numGenerationStagesDone = 0;	//ChunkGenerationStages finished, set by the worker that finished each
+	bool					m_isGenerationStageQueued = false;	//main thread only: a stage job is in flight
+	bool					m_hasSkyLight = false;			//the light stage already set the sky flags and outdoor light
 	int						m_caveCheckRadius = 40;
 	int m_caveBlockSteps =  8;
 	int m_caveNodeAmount = 70;
 	int m_caveDepthStart = 20;
 	float m_caveTurnRate = 35.0f;
 	float m_caveMaxRadius = 10.0f;
+
+	//File API calls made by chunk save/load, shared by every thread (read by BenchmarkChunkIO)
+	static std::atomic<int>		s_numFileExistsChecks;
+	static std::atomic<int>		s_numFileReads;
+	static std::atomic<int>		s_numFileWrites;
+	static std::atomic<int>		s_numFolderCreates;
+	static std::atomic<int64_t>	s_numFileBytesRead;
+	static std::atomic<int64_t>	s_numFileBytesWritten;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 constexpr int DISK_JOB_TYPE = 1;
-constexpr int CHUNK_GENERATION_JOB_TYPE = 1 << 1;
+constexpr int CHUNK_TERRAIN_JOB_TYPE = 1 << 1;
+constexpr int CHUNK_CARVE_JOB_TYPE = 1 << 2;
+constexpr int CHUNK_DECORATE_JOB_TYPE = 1 << 3;
+constexpr int CHUNK_LIGHT_JOB_TYPE = 1 << 4;
+constexpr int CHUNK_GENERATION_JOB_TYPE = CHUNK_TERRAIN_JOB_TYPE | CHUNK_CARVE_JOB_TYPE | CHUNK_DECORATE_JOB_TYPE | CHUNK_LIGHT_JOB_TYPE;	//any stage
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Job type of a generation stage and what it needs from the 8 neighboring chunks before it may start
+struct ChunkGenerationStageDef
+{
+	char const*		m_name = nullptr;
+	int				m_jobType = 0;
+	int				m_numNeighborStagesRequired = 0;	//every neighbor must have finished this many stages; 0 needs none
+};
+ChunkGenerationStageDef const& GetChunkGenerationStageDef(ChunkGenerationStage stage);
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class ChunkGenerationJob : public Job {
 public:
-	ChunkGenerationJob(Chunk* chunk) :
+	ChunkGenerationJob(Chunk* chunk, ChunkGenerationStage stage = GENERATION_STAGE_TERRAIN, int bandIndex = 0, int numBands = 1) :
+		Job(GetChunkGenerationStageDef(stage).m_jobType),
 		m_chunk(chunk),
-		Job::Job(CHUNK_GENERATION_JOB_TYPE)
+		m_stage(stage),
+		m_bandIndex(bandIndex),
+		m_numBands(numBands)
 	{}
 
 	virtual void Execute() override;
 	virtual void OnFinished() override;
 	
 	Chunk* m_chunk = nullptr;
+	ChunkGenerationStage m_stage = GENERATION_STAGE_TERRAIN;
+	int m_bandIndex = 0;
+	int m_numBands = 1;				//more than one splits the terrain stage's rows across jobs
+	bool m_completesStage = true;	//false for bands that finished before the last one; only the last may touch the chunk after
+	JobTiming m_timing;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class ChunkDiskLoadJob : public Job
 {
 public:
 	ChunkDiskLoadJob(Chunk* chunk) :
-		m_chunk(chunk),
-		Job::Job(DISK_JOB_TYPE) {}
+		Job(DISK_JOB_TYPE),
+		m_chunk(chunk) {}
 
 	virtual void Execute() override;
 	virtual void OnFinished() override;
 
 	Chunk* m_chunk = nullptr;
 	bool m_loadingSuccessful = false;
+	JobTiming m_timing;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class ChunkDiskSaveJob : public Job 
 {
 public:
 	ChunkDiskSaveJob(Chunk* chunk) :
-		m_chunk(chunk),
-		Job::Job(DISK_JOB_TYPE) {}
+		Job(DISK_JOB_TYPE),
+		m_chunk(chunk) {}
 
 	virtual void Execute() override;
 	virtual void OnFinished() override;
 
 	Chunk* m_chunk = nullptr;
+	JobTiming m_timing;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
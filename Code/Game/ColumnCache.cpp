@@ -0,0 +1,261 @@
+#include "Game/ColumnCache.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/NoiseTile.hpp"
+#include "ThirdParty/Squirrel/SmoothNoise.hpp"
+#include "ThirdParty/Squirrel/RawNoise.hpp"
+#include <cmath>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum ColumnNoiseLayer
+{
+	COLUMN_NOISE_TEMPERATURE,
+	COLUMN_NOISE_HUMIDITY,
+	COLUMN_NOISE_CLOUD,
+	COLUMN_NOISE_OCEAN,
+	COLUMN_NOISE_HILL,
+	COLUMN_NOISE_HEIGHT,
+	NUM_COLUMN_NOISE_LAYERS
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static void InitializeColumnNoiseLayers(unsigned int worldSeed, float (*noiseValues)[CHUNK_BLOCKS_PER_LAYER], NoiseTileLayer* out_layers)
+{
+	NoiseTileLayer const layers[NUM_COLUMN_NOISE_LAYERS] =
+	{
+		{ 800.f, 9, 0.5f, 2.f, true, worldSeed + 1, noiseValues[COLUMN_NOISE_TEMPERATURE] },
+		{ 800.f, 5, 0.5f, 2.f, true, worldSeed + 2, noiseValues[COLUMN_NOISE_HUMIDITY] },
+		{  30.f, 9, 0.5f, 2.f, true, worldSeed + 9, noiseValues[COLUMN_NOISE_CLOUD] },
+		{ 800.f, 7, 0.5f, 2.f, true, worldSeed + 3, noiseValues[COLUMN_NOISE_OCEAN] },
+		{ 400.f, 5, 0.5f, 2.f, true, worldSeed + 4, noiseValues[COLUMN_NOISE_HILL] },
+		{ 200.f, 7, 0.5f, 2.f, true, worldSeed,     noiseValues[COLUMN_NOISE_HEIGHT] },
+	};
+	for (int layerIndex = 0; layerIndex < NUM_COLUMN_NOISE_LAYERS; layerIndex++)
+	{
+		out_layers[layerIndex] = layers[layerIndex];
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+ColumnCache::ColumnCache(ColumnCacheConfig const& config)
+	:m_config(config)
+	,m_chunkColumns(config.m_maxCachedChunks, MEMORY_COLUMN_CACHE, PERF_COUNTER_COLUMN_CACHE_HITS, PERF_COUNTER_COLUMN_CACHE_MISSES, &ColumnCache::GetChunkColumnsBytes)
+{
+	if (!IsValidClimateLatticeSpacing(m_config.m_climateLatticeSpacing))
+	{
+		m_config.m_climateLatticeSpacing = 0;
+	}
+
+	//The scalar noise still answers single-column and lattice lookups next to the tiles, so both must give the same terrain
+	if (m_config.m_useNoiseTiles && !DoNoiseTilesMatchScalarNoise())
+	{
+		m_config.m_useNoiseTiles = false;
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::shared_ptr<ChunkColumns const> ColumnCache::GetChunkColumns(IntVec2 const& chunkCoords)
+{
+	std::shared_ptr<ChunkColumns const> cachedColumns = m_chunkColumns.Find(chunkCoords);
+	if (cachedColumns != nullptr)
+	{
+		return cachedColumns;
+	}
+
+	//Computed outside the cache lock so other workers keep hitting the cache meanwhile
+	std::shared_ptr<ChunkColumns> chunkColumns = std::make_shared<ChunkColumns>();
+	ComputeChunkColumns(chunkCoords, m_config, *chunkColumns);
+	return m_chunkColumns.Insert(chunkCoords, chunkColumns);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// For columns computed elsewhere, e.g. by the row bands of a split generation job; returns whichever copy the cache keeps
+std::shared_ptr<ChunkColumns const> ColumnCache::InsertChunkColumns(IntVec2 const& chunkCoords, std::shared_ptr<ChunkColumns const> const& chunkColumns)
+{
+	return m_chunkColumns.Insert(chunkCoords, chunkColumns);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+ColumnData ColumnCache::GetColumn(int globalX, int globalY)
+{
+	IntVec2 chunkCoords(globalX >> CHUNK_BITS_X, globalY >> CHUNK_BITS_Y);
+	std::shared_ptr<ChunkColumns const> chunkColumns = GetChunkColumns(chunkCoords);
+	return chunkColumns->GetColumn(globalX & CHUNK_MAX_X, globalY & CHUNK_MAX_Y);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int ColumnCache::GetNumCachedChunks()
+{
+	return m_chunkColumns.GetNumEntries();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+size_t ColumnCache::GetChunkColumnsBytes(ChunkColumns const& chunkColumns)
+{
+	UNUSED(chunkColumns);
+	return sizeof(ChunkColumns);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int ColumnCache::ComputeGroundHeightZ(float globalX, float globalY, unsigned int worldSeed)
+{
+	float oceanNoise = Compute2dPerlinNoise(globalX, globalY, 800.f, 7, 0.5f, 2.f, true, worldSeed + 3);
+	float hillNoise = Compute2dPerlinNoise(globalX, globalY, 400.f, 5, 0.5f, 2.f, true, worldSeed + 4);
+	float heightNoise = Compute2dPerlinNoise(globalX, globalY, 200.f, 7, 0.5f, 2.f, true, worldSeed);
+	return ComputeGroundHeightZFromNoise(oceanNoise, hillNoise, heightNoise);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int ColumnCache::ComputeGroundHeightZFromNoise(float oceanNoise, float hillNoise, float heightNoise)
+{
+	int riverDepth = 6;
+	int oceanHeightZ = CHUNK_SIZE_Z / 2;
+	int lowestOceanFloorZ = CHUNK_SIZE_Z / 4;
+	int maxOceanLowering = oceanHeightZ - lowestOceanFloorZ;
+
+	int   groundHeightZ = 0;
+	float oceanness = 0.f;
+	float hilliness = 0.f;
+
+	oceanness = 0.5f + 0.5f * oceanNoise;
+	oceanness = SmoothStep3(SmoothStep3(oceanness));
+	hilliness = 0.5f + 0.5f * hillNoise;
+	hilliness = SmoothStep3(SmoothStep3(hilliness));		//smooth step makes the extreme more extremey.
+
+	//calculate terrain height, considering oceanness(lowers land and hilliness(exaggerates height changes))
+	int mountainMaxHeight = CHUNK_SIZE_Z - oceanHeightZ + riverDepth;
+	float mountainHeight = hilliness * float(mountainMaxHeight);
+	heightNoise = fabsf(heightNoise);
+	groundHeightZ = oceanHeightZ - riverDepth + int(mountainHeight * heightNoise);
+
+	//Lower terrain where oceanness is high(and do the transition or lerp)
+	float oceanLoweringEffectStrength = RangeMapClamped(oceanness, 0.5f, 1.f, 0.f, 1.f);
+	int oceanLoweringAmount = int(oceanLoweringEffectStrength * float(maxOceanLowering));
+	groundHeightZ -= oceanLoweringAmount;
+
+	return groundHeightZ;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Samples one noise layer every latticeSpacing blocks, including the chunk's far edge so neighboring chunks share lattice
+// points and meet without seams, then fills the columns of rows [minLocalY, maxLocalY) bilinearly
+static void InterpolateLatticeNoise(float chunkMinsX, float chunkMinsY, NoiseTileLayer const& layer, int latticeSpacing, int minLocalY, int maxLocalY)
+{
+	int latticeWidth = (CHUNK_SIZE_X / latticeSpacing) + 1;
+	int latticeHeight = (CHUNK_SIZE_Y / latticeSpacing) + 1;
+	float latticeValues[(CHUNK_SIZE_X / 2 + 1) * (CHUNK_SIZE_Y / 2 + 1)];
+	for (int latticeY = 0; latticeY < latticeHeight; latticeY++)
+	{
+		for (int latticeX = 0; latticeX < latticeWidth; latticeX++)
+		{
+			latticeValues[latticeX + latticeY * latticeWidth] = Compute2dPerlinNoise(chunkMinsX + float(latticeX * latticeSpacing), chunkMinsY + float(latticeY * latticeSpacing),
+				layer.m_scale, layer.m_numOctaves, layer.m_octavePersistence, layer.m_octaveScale, layer.m_renormalize, layer.m_seed);
+		}
+	}
+
+	float invLatticeSpacing = 1.f / float(latticeSpacing);
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		int cellY = localY / latticeSpacing;
+		float fractionY = float(localY - cellY * latticeSpacing) * invLatticeSpacing;
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			int cellX = localX / latticeSpacing;
+			float fractionX = float(localX - cellX * latticeSpacing) * invLatticeSpacing;
+			float const* southWest = &latticeValues[cellX + cellY * latticeWidth];
+			float const* northWest = southWest + latticeWidth;
+			float southValue = Interpolate(southWest[0], southWest[1], fractionX);
+			float northValue = Interpolate(northWest[0], northWest[1], fractionX);
+			layer.m_out_values[localX + (localY << CHUNK_BITS_X)] = Interpolate(southValue, northValue, fractionY);
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+bool ColumnCache::IsValidClimateLatticeSpacing(int latticeSpacing)
+{
+	bool isPowerOfTwo = latticeSpacing > 1 && (latticeSpacing & (latticeSpacing - 1)) == 0;
+	return isPowerOfTwo && latticeSpacing <= CHUNK_SIZE_X && latticeSpacing <= CHUNK_SIZE_Y;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Runs the tile kernel and the scalar noise of the engine that is actually linked over a few tiles of every column layer
+static bool DoNoiseTileSamplesMatchScalarNoise()
+{
+	constexpr float MAX_NOISE_DIFFERENCE = 1e-4f;
+	IntVec2 const sampleChunkCoords[] = { IntVec2(0, 0), IntVec2(-7, 3), IntVec2(1021, -389) };
+	float tileNoise[NUM_COLUMN_NOISE_LAYERS][CHUNK_BLOCKS_PER_LAYER];
+	float scalarNoise[NUM_COLUMN_NOISE_LAYERS][CHUNK_BLOCKS_PER_LAYER];
+	NoiseTileLayer tileLayers[NUM_COLUMN_NOISE_LAYERS];
+	NoiseTileLayer scalarLayers[NUM_COLUMN_NOISE_LAYERS];
+	InitializeColumnNoiseLayers(0, tileNoise, tileLayers);
+	InitializeColumnNoiseLayers(0, scalarNoise, scalarLayers);
+
+	for (int sampleIndex = 0; sampleIndex < (int)(sizeof(sampleChunkCoords) / sizeof(sampleChunkCoords[0])); sampleIndex++)
+	{
+		float chunkMinsX = (float)CHUNK_SIZE_X * (float)sampleChunkCoords[sampleIndex].x;
+		float chunkMinsY = (float)CHUNK_SIZE_Y * (float)sampleChunkCoords[sampleIndex].y;
+		Compute2dPerlinNoiseTile(chunkMinsX, chunkMinsY, tileLayers, NUM_COLUMN_NOISE_LAYERS);
+		Compute2dPerlinNoiseTileScalar(chunkMinsX, chunkMinsY, scalarLayers, NUM_COLUMN_NOISE_LAYERS);
+		for (int layerIndex = 0; layerIndex < NUM_COLUMN_NOISE_LAYERS; layerIndex++)
+		{
+			for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; columnIndex++)
+			{
+				if (fabsf(tileNoise[layerIndex][columnIndex] - scalarNoise[layerIndex][columnIndex]) > MAX_NOISE_DIFFERENCE)
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// The tile kernel re-implements Compute2dPerlinNoise's gradients, octave offset and normalizer, so it is only right for
+// the engine it was written against; checked once per process
+bool ColumnCache::DoNoiseTilesMatchScalarNoise()
+{
+	static bool const s_doNoiseTilesMatch = DoNoiseTileSamplesMatchScalarNoise();
+	return s_doNoiseTilesMatch;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Fills rows [minLocalY, maxLocalY) of out_chunkColumns; the other rows are left untouched
+void ColumnCache::ComputeChunkColumns(IntVec2 const& chunkCoords, ColumnCacheConfig const& config, ChunkColumns& out_chunkColumns, int minLocalY, int maxLocalY)
+{
+	unsigned int worldSeed = config.m_worldSeed;
+	float chunkMinsX = (float)CHUNK_SIZE_X * (float)chunkCoords.x;
+	float chunkMinsY = (float)CHUNK_SIZE_Y * (float)chunkCoords.y;
+
+	float noiseValues[NUM_COLUMN_NOISE_LAYERS][CHUNK_BLOCKS_PER_LAYER];
+	NoiseTileLayer layers[NUM_COLUMN_NOISE_LAYERS];
+	InitializeColumnNoiseLayers(worldSeed, noiseValues, layers);
+
+	//The 800-block climate layers barely change inside a chunk, so in lattice mode they are interpolated instead
+	bool useClimateLattice = IsValidClimateLatticeSpacing(config.m_climateLatticeSpacing);
+	NoiseTileLayer perColumnLayers[NUM_COLUMN_NOISE_LAYERS];
+	int numPerColumnLayers = 0;
+	for (int layerIndex = 0; layerIndex < NUM_COLUMN_NOISE_LAYERS; layerIndex++)
+	{
+		bool isClimateLayer = layerIndex == COLUMN_NOISE_TEMPERATURE || layerIndex == COLUMN_NOISE_HUMIDITY || layerIndex == COLUMN_NOISE_OCEAN;
+		if (useClimateLattice && isClimateLayer)
+		{
+			InterpolateLatticeNoise(chunkMinsX, chunkMinsY, layers[layerIndex], config.m_climateLatticeSpacing, minLocalY, maxLocalY);
+		}
+		else
+		{
+			perColumnLayers[numPerColumnLayers++] = layers[layerIndex];
+		}
+	}
+
+	//Chunks generated without a cache pass a config the constructor never checked
+	if (config.m_useNoiseTiles && DoNoiseTilesMatchScalarNoise())
+	{
+		Compute2dPerlinNoiseTile(chunkMinsX, chunkMinsY, perColumnLayers, numPerColumnLayers, minLocalY, maxLocalY);
+	}
+	else
+	{
+		Compute2dPerlinNoiseTileScalar(chunkMinsX, chunkMinsY, perColumnLayers, numPerColumnLayers, minLocalY, maxLocalY);
+	}
+
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			int columnIndex = localX + (localY << CHUNK_BITS_X);
+			ColumnData& column = out_chunkColumns.m_columns[columnIndex];
+			column.m_temperature = 0.5f + 0.5f * noiseValues[COLUMN_NOISE_TEMPERATURE][columnIndex];
+			column.m_temperature += 0.01f * Get2dNoiseZeroToOne(static_cast<int>(chunkMinsX + float(localX)), static_cast<int>(chunkMinsY + float(localY)), worldSeed + 21);
+			column.m_humidity = 0.5f + 0.5f * noiseValues[COLUMN_NOISE_HUMIDITY][columnIndex];
+			column.m_cloudness = RangeMapClamped(noiseValues[COLUMN_NOISE_CLOUD][columnIndex], -1.f, 1.f, 0.f, 1.f);
+			column.m_groundHeightZ = ComputeGroundHeightZFromNoise(noiseValues[COLUMN_NOISE_OCEAN][columnIndex], noiseValues[COLUMN_NOISE_HILL][columnIndex], noiseValues[COLUMN_NOISE_HEIGHT][columnIndex]);
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
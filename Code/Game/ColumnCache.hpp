@@ -0,0 +1,60 @@
+#pragma once
+#include "Game/Chunks.hpp"
+#include "Game/SharedLRUCache.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <memory>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Per-column terrain inputs that only depend on the world seed and the column's global XY
+struct ColumnData
+{
+	int		m_groundHeightZ = 0;
+	float	m_temperature = 0.f;
+	float	m_humidity = 0.f;
+	float	m_cloudness = 0.f;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ChunkColumns
+{
+	ColumnData	m_columns[CHUNK_BLOCKS_PER_LAYER];		//indexed localX + localY * CHUNK_SIZE_X
+
+	ColumnData const& GetColumn(int localX, int localY) const { return m_columns[localX + (localY << CHUNK_BITS_X)]; }
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ColumnCacheConfig
+{
+	unsigned int	m_worldSeed = 0;
+	bool			m_useNoiseTiles = true;			//batched SSE noise for whole chunks instead of scalar noise per column, if it matches it
+	int				m_climateLatticeSpacing = 0;	//2, 4, 8 or 16: temperature, humidity and oceanness sampled every N blocks and interpolated
+	int				m_maxCachedChunks = 2048;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// World-level cache of ground height and climate per column, keyed by chunk coords and shared by every generation thread.
+// GenerateTerrain, AddTrees (which looks at columns in neighboring chunks) and the cave passes all read from it, so the
+// multi-octave noise behind each column is evaluated once per world instead of once per pass per chunk.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class ColumnCache
+{
+public:
+	explicit ColumnCache(ColumnCacheConfig const& config);
+
+	std::shared_ptr<ChunkColumns const>	GetChunkColumns(IntVec2 const& chunkCoords);
+	ColumnData							GetColumn(int globalX, int globalY);
+	unsigned int						GetWorldSeed() const { return m_config.m_worldSeed; }
+	ColumnCacheConfig const&			GetConfig() const { return m_config; }
+	std::shared_ptr<ChunkColumns const>	InsertChunkColumns(IntVec2 const& chunkCoords, std::shared_ptr<ChunkColumns const> const& chunkColumns);
+	int									GetNumCachedChunks();
+
+	static int			ComputeGroundHeightZ(float globalX, float globalY, unsigned int worldSeed);
+	static int			ComputeGroundHeightZFromNoise(float oceanNoise, float hillNoise, float heightNoise);
+	static void			ComputeChunkColumns(IntVec2 const& chunkCoords, ColumnCacheConfig const& config, ChunkColumns& out_chunkColumns, int minLocalY = 0, int maxLocalY = CHUNK_SIZE_Y);
+	static bool			IsValidClimateLatticeSpacing(int latticeSpacing);
+	static bool			DoNoiseTilesMatchScalarNoise();
+
+private:
+	static size_t		GetChunkColumnsBytes(ChunkColumns const& chunkColumns);
+
+	ColumnCacheConfig							m_config;
+	SharedLRUCache<IntVec2, ChunkColumns>		m_chunkColumns;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
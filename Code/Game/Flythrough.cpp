@@ -0,0 +1,250 @@
+#include "Game/Flythrough.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/World.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <map>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint8_t const FLYTHROUGH_FILE_VERSION = 1;
+static char const* const DEFAULT_FLYTHROUGH_PATH = "Saves/Flythroughs/Flythrough.fly";
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static void AppendToBuffer(std::vector<uint8_t>& buffer, T const& value)
+{
+	uint8_t const* valueBytes = reinterpret_cast<uint8_t const*>(&value);
+	buffer.insert(buffer.end(), valueBytes, valueBytes + sizeof(T));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static bool ReadFromBuffer(std::vector<uint8_t> const& buffer, size_t& readOffset, T& out_value)
+{
+	if (readOffset + sizeof(T) > buffer.size())
+	{
+		return false;
+	}
+	memcpy(&out_value, &buffer[readOffset], sizeof(T));
+	readOffset += sizeof(T);
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Flythrough::RecordFrame(float deltaSeconds, Vec3 const& camPosition, EulerAngles const& camOrientation, uint8_t actions, uint8_t blockTypeToAdd)
+{
+	FlythroughFrame frame;
+	frame.m_deltaSeconds = deltaSeconds;
+	frame.m_camPosition = camPosition;
+	frame.m_camOrientation = camOrientation;
+	frame.m_actions = actions;
+	frame.m_blockTypeToAdd = blockTypeToAdd;
+	m_frames.push_back(frame);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Flythrough::SaveToFile(std::string const& filePath) const
+{
+	std::vector<uint8_t> buffer;
+	buffer.reserve(16 + m_frames.size() * 32);
+	buffer.push_back('G');
+	buffer.push_back('F');
+	buffer.push_back('L');
+	buffer.push_back('Y');
+	buffer.push_back(FLYTHROUGH_FILE_VERSION);
+	AppendToBuffer(buffer, static_cast<uint32_t>(m_frames.size()));
+
+	for (int frameIndex = 0; frameIndex < (int)m_frames.size(); frameIndex++)
+	{
+		FlythroughFrame const& frame = m_frames[frameIndex];
+		AppendToBuffer(buffer, frame.m_deltaSeconds);
+		AppendToBuffer(buffer, frame.m_camPosition.x);
+		AppendToBuffer(buffer, frame.m_camPosition.y);
+		AppendToBuffer(buffer, frame.m_camPosition.z);
+		AppendToBuffer(buffer, frame.m_camOrientation.m_yawDegrees);
+		AppendToBuffer(buffer, frame.m_camOrientation.m_pitchDegrees);
+		AppendToBuffer(buffer, frame.m_camOrientation.m_rollDegrees);
+		buffer.push_back(frame.m_actions);
+		buffer.push_back(frame.m_blockTypeToAdd);
+	}
+
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), errorCode);
+	return FileWriteFromBuffer(buffer, filePath);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Flythrough::LoadFromFile(std::string const& filePath)
+{
+	m_frames.clear();
+	if (!DoesFileExist(filePath))
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> buffer;
+	FileReadToBuffer(buffer, filePath);
+	if (buffer.size() < 9 || buffer[0] != 'G' || buffer[1] != 'F' || buffer[2] != 'L' || buffer[3] != 'Y' || buffer[4] != FLYTHROUGH_FILE_VERSION)
+	{
+		return false;
+	}
+
+	size_t readOffset = 5;
+	uint32_t numFrames = 0;
+	ReadFromBuffer(buffer, readOffset, numFrames);
+	m_frames.reserve(numFrames);
+
+	for (uint32_t frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		FlythroughFrame frame;
+		bool wasRead = ReadFromBuffer(buffer, readOffset, frame.m_deltaSeconds)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_camPosition.x)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_camPosition.y)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_camPosition.z)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_camOrientation.m_yawDegrees)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_camOrientation.m_pitchDegrees)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_camOrientation.m_rollDegrees)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_actions)
+			&& ReadFromBuffer(buffer, readOffset, frame.m_blockTypeToAdd);
+		if (!wasRead)
+		{
+			m_frames.clear();
+			return false;
+		}
+		m_frames.push_back(frame);
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Flythrough::RegisterRecordCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("FlythroughRecord", Flythrough::Event_FlythroughRecord);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Flythrough::RegisterReplayCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("FlythroughReplay", Flythrough::Event_FlythroughReplay);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// FlythroughRecord file=Saves/Flythroughs/Flythrough.fly
+//	First call starts recording the running world, second call stops and writes the file.
+bool Flythrough::Event_FlythroughRecord(EventArgs& args)
+{
+	if (g_theGame == nullptr || g_theGame->m_world == nullptr)
+	{
+		PrintToConsole("FlythroughRecord: no world is running", Rgba8(255, 0, 0, 255));
+		return false;
+	}
+
+	World* world = g_theGame->m_world;
+	if (world->m_flythroughRecording == nullptr)
+	{
+		world->m_flythroughRecording = new Flythrough();
+		PrintToConsole("FlythroughRecord: recording started, run FlythroughRecord again to stop", Rgba8(0, 255, 255, 255));
+		return true;
+	}
+
+	std::string filePath = args.GetValue("file", std::string(DEFAULT_FLYTHROUGH_PATH));
+	Flythrough* recording = world->m_flythroughRecording;
+	world->m_flythroughRecording = nullptr;
+
+	bool wasSaved = recording->SaveToFile(filePath);
+	PrintToConsole(Stringf("FlythroughRecord: %s %i frames to %s", wasSaved ? "saved" : "FAILED to save", (int)recording->m_frames.size(), filePath.c_str()),
+		wasSaved ? Rgba8(0, 255, 255, 255) : Rgba8(255, 0, 0, 255));
+
+	delete recording;
+	return wasSaved;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// FlythroughReplay file=Saves/Flythroughs/Flythrough.fly sync=true
+//	Replays a recording through a fresh World::Update using the recorded delta seconds. With sync=true every frame first waits
+//	for all outstanding chunk jobs, so each frame sees the same set of completed chunks on every run; the wait is not counted
+//	as frame time. Reports World::Update percentiles, missing chunks inside the activation radius and pop-in latency, which
+//	is the time from a chunk coordinate entering the activation radius until that chunk is active.
+bool Flythrough::Event_FlythroughReplay(EventArgs& args)
+{
+	std::string filePath = args.GetValue("file", std::string(DEFAULT_FLYTHROUGH_PATH));
+	bool isSynchronous = args.GetValue("sync", true);
+
+	Flythrough flythrough;
+	if (!flythrough.LoadFromFile(filePath) || flythrough.m_frames.empty())
+	{
+		PrintToConsole(Stringf("FlythroughReplay: could not load %s", filePath.c_str()), Rgba8(255, 0, 0, 255));
+		return false;
+	}
+
+	World* world = new World();
+	int numFrames = (int)flythrough.m_frames.size();
+
+	std::vector<double> frameTimes;
+	frameTimes.reserve(numFrames);
+	std::vector<double> popInSeconds;
+	std::vector<double> popInFrames;
+	std::map<IntVec2, std::pair<double, int>> missingSince;
+	std::vector<IntVec2> missingChunks;
+	int totalMissingChunks = 0;
+	int maxMissingChunks = 0;
+	double replayTime = 0.0;
+
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		FlythroughFrame const& frame = flythrough.m_frames[frameIndex];
+		if (isSynchronous)
+		{
+			g_theJobSystem->WaitUntilQueuedJobsCompletion();
+		}
+
+		world->m_camPosition = frame.m_camPosition;
+		world->m_camOrientation = frame.m_camOrientation;
+		world->m_worldCamera.SetTransform(frame.m_camPosition, frame.m_camOrientation);
+		world->m_blockTypeToAdd = frame.m_blockTypeToAdd;
+		world->m_placeBlockAtCurrentPos = (frame.m_actions & FLYTHROUGH_ACTION_PLACE_AT_CAMERA) != 0;
+		world->m_replayActions = frame.m_actions;
+
+		double frameStartTime = GetCurrentTimeSeconds();
+		world->Update(frame.m_deltaSeconds);
+		double frameSeconds = GetCurrentTimeSeconds() - frameStartTime;
+		frameTimes.push_back(frameSeconds);
+		replayTime += frameSeconds;
+
+		//Pop-in is measured in replay time (sum of World::Update time) so sync waits do not count against it
+		world->GetMissingChunksInActivationRange(missingChunks);
+		totalMissingChunks += (int)missingChunks.size();
+		maxMissingChunks = std::max(maxMissingChunks, (int)missingChunks.size());
+
+		std::map<IntVec2, std::pair<double, int>> stillMissing;
+		for (int missingIndex = 0; missingIndex < (int)missingChunks.size(); missingIndex++)
+		{
+			auto missingIt = missingSince.find(missingChunks[missingIndex]);
+			stillMissing[missingChunks[missingIndex]] = (missingIt != missingSince.end()) ? missingIt->second : std::make_pair(replayTime, frameIndex);
+		}
+		for (auto missingIt = missingSince.begin(); missingIt != missingSince.end(); ++missingIt)
+		{
+			if (stillMissing.find(missingIt->first) == stillMissing.end() && world->DoesChunkExist(missingIt->first))
+			{
+				popInSeconds.push_back(replayTime - missingIt->second.first);
+				popInFrames.push_back((double)(frameIndex - missingIt->second.second));
+			}
+		}
+		missingSince.swap(stillMissing);
+	}
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+	std::sort(popInSeconds.begin(), popInSeconds.end());
+	std::sort(popInFrames.begin(), popInFrames.end());
+
+	PrintToConsole(Stringf("FlythroughReplay %s: %i frames, sync=%s", filePath.c_str(), numFrames, isSynchronous ? "true" : "false"), Rgba8(0, 255, 255, 255));
+	PrintToConsole(Stringf("  World::Update ms: p50=%.2f p90=%.2f p99=%.2f max=%.2f",
+		1000.0 * Benchmark::GetPercentile(frameTimes, 0.5f), 1000.0 * Benchmark::GetPercentile(frameTimes, 0.9f),
+		1000.0 * Benchmark::GetPercentile(frameTimes, 0.99f), 1000.0 * frameTimes.back()));
+	PrintToConsole(Stringf("  missing chunks in activation radius: mean=%.1f max=%i", (double)totalMissingChunks / (double)numFrames, maxMissingChunks));
+	PrintToConsole(Stringf("  pop-in: %i chunks, p50=%.1fms/%.0f frames, p99=%.1fms/%.0f frames",
+		(int)popInSeconds.size(), 1000.0 * Benchmark::GetPercentile(popInSeconds, 0.5f), Benchmark::GetPercentile(popInFrames, 0.5f),
+		1000.0 * Benchmark::GetPercentile(popInSeconds, 0.99f), Benchmark::GetPercentile(popInFrames, 0.99f)));
+
+	delete world;
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
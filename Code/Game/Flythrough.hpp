@@ -0,0 +1,45 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum FlythroughAction : uint8_t
+{
+	FLYTHROUGH_ACTION_NONE				= 0,
+	FLYTHROUGH_ACTION_DIG				= 1 << 0,
+	FLYTHROUGH_ACTION_PLACE				= 1 << 1,
+	FLYTHROUGH_ACTION_PLACE_AT_CAMERA	= 1 << 2,	//m_placeBlockAtCurrentPos was on for this frame's place
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct FlythroughFrame
+{
+	float		m_deltaSeconds = 0.f;
+	Vec3		m_camPosition;
+	EulerAngles	m_camOrientation;
+	uint8_t		m_actions = FLYTHROUGH_ACTION_NONE;
+	uint8_t		m_blockTypeToAdd = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// A recorded camera path plus dig/place inputs, one entry per World::Update.
+// The camera stored for a frame is the one World::Update started with, so a replay can restore it before updating.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class Flythrough
+{
+public:
+	void				RecordFrame(float deltaSeconds, Vec3 const& camPosition, EulerAngles const& camOrientation, uint8_t actions, uint8_t blockTypeToAdd);
+	bool				SaveToFile(std::string const& filePath) const;
+	bool				LoadFromFile(std::string const& filePath);
+
+	static void			RegisterRecordCommands();
+	static void			RegisterReplayCommands();
+	static bool			Event_FlythroughRecord(EventArgs& args);
+	static bool			Event_FlythroughReplay(EventArgs& args);
+
+public:
+	std::vector<FlythroughFrame> m_frames;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1,5 +1,6 @@
 #pragma once
 #include "Game/GameCommon.hpp"
+#include "Engine/Renderer/Camera.hpp"
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class Camera;
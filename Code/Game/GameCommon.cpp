@@ -1,12 +1,32 @@
 #pragma once
 #include "GameCommon.hpp"
-#include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#if !defined(GAME_HEADLESS)
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#endif
+#include <cstdio>
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 RandomNumberGenerator g_rng;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+void PrintToConsole(std::string const& text, Rgba8 const& color)
+{
+#if defined(GAME_HEADLESS)
+	UNUSED(color);
+	printf("%s\n", text.c_str());
+	fflush(stdout);
+#else
+	if (g_theDevConsole)
+	{
+		g_theDevConsole->AddLine(color, text);
+	}
+#endif
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void DebugDrawLine(Vec2 const& start, Vec2 const& end, float thickness, Rgba8 const& color)
 {
 	float radius = thickness * 0.5f;
@@ -85,4 +105,4 @@ void DebugDrawRing(Vec2 const& center, float radius, float thickness, Rgba8 cons
 	g_theRenderer->BindTexture(nullptr);
 	g_theRenderer->DrawVertexArray(NUM_VERTS, verts);
 }
-
+#endif
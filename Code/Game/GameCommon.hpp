@@ -1,22 +1,30 @@
 #pragma once
 #include "Engine/Math/RandomNumberGenerator.hpp"
-#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/vertexUtils.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#if !defined(GAME_HEADLESS)
+#include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Window/Window.hpp"
-#include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
-#include "Engine/Math/IntVec2.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#endif
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class RandomNumberGenerator;
 class App;
 class Game;
+class Renderer;
+class InputSystem;
+class AudioSystem;
+class Window;
 class SpriteSheet;
 class Texture;
 class EventSystem;
@@ -34,6 +42,7 @@ extern JobSystem* g_theJobSystem;
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 IntVec2   const		TERRAIN_SPRITE_LAYOUT = IntVec2(64, 64);
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+void PrintToConsole(std::string const& text, Rgba8 const& color = Rgba8(255, 255, 255, 255));
 void DebugDrawRing(Vec2 const& center, float radius, float thickness, Rgba8 const& color);
 void DebugDrawLine(Vec2 const& start, Vec2 const& end, float thickness, Rgba8 const& color);
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
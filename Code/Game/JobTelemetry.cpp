@@ -0,0 +1,186 @@
+#include "Game/JobTelemetry.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::atomic<int>		JobTelemetry::s_numQueued[NUM_JOB_TELEMETRY_TYPES] = {};
+std::atomic<int>		JobTelemetry::s_numStarted[NUM_JOB_TELEMETRY_TYPES] = {};
+std::atomic<int>		JobTelemetry::s_maxQueueDepth[NUM_JOB_TELEMETRY_TYPES] = {};
+std::atomic<int64_t>	JobTelemetry::s_threadBusyMicroseconds[MAX_THREADS] = {};
+std::atomic<int>		JobTelemetry::s_threadNumJobs[MAX_THREADS] = {};
+std::atomic<int>		JobTelemetry::s_threadJobTypeMask[MAX_THREADS] = {};
+std::atomic<int>		JobTelemetry::s_numThreads = 0;
+std::mutex				JobTelemetry::s_threadIndexMutex;
+std::atomic<double>	JobTelemetry::s_resetSeconds = 0.0;
+std::vector<double>		JobTelemetry::s_latencySeconds[NUM_JOB_TELEMETRY_TYPES];
+std::vector<double>		JobTelemetry::s_executeSeconds[NUM_JOB_TELEMETRY_TYPES];
+int						JobTelemetry::s_numDroppedSamples = 0;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobTelemetry::OnJobQueued(JobTelemetryType jobType, JobTiming& timing)
+{
+	timing.m_queuedSeconds = GetCurrentTimeSeconds();
+	s_numQueued[jobType]++;
+
+	int queueDepth = GetQueueDepth(jobType);
+	int maxQueueDepth = s_maxQueueDepth[jobType];
+	while (queueDepth > maxQueueDepth && !s_maxQueueDepth[jobType].compare_exchange_weak(maxQueueDepth, queueDepth))
+	{
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobTelemetry::OnJobStarted(JobTelemetryType jobType, JobTiming& timing)
+{
+	timing.m_startedSeconds = GetCurrentTimeSeconds();
+	if (IsTracked(timing))
+	{
+		s_numStarted[jobType]++;
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobTelemetry::OnJobFinished(JobTelemetryType jobType, JobTiming& timing)
+{
+	timing.m_finishedSeconds = GetCurrentTimeSeconds();
+	if (!IsTracked(timing))
+	{
+		return;
+	}
+
+	int threadIndex = GetThreadIndex();
+	if (threadIndex < MAX_THREADS)
+	{
+		s_threadBusyMicroseconds[threadIndex] += static_cast<int64_t>((timing.m_finishedSeconds - timing.m_startedSeconds) * 1000000.0);
+		s_threadNumJobs[threadIndex]++;
+		s_threadJobTypeMask[threadIndex] |= (1 << jobType);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobTelemetry::OnJobRetrieved(JobTelemetryType jobType, JobTiming const& timing)
+{
+	if (!IsTracked(timing))
+	{
+		return;
+	}
+
+	if ((int)s_latencySeconds[jobType].size() >= MAX_SAMPLES_PER_TYPE)
+	{
+		s_numDroppedSamples++;
+		return;
+	}
+
+	s_latencySeconds[jobType].push_back(timing.m_startedSeconds - timing.m_queuedSeconds);
+	s_executeSeconds[jobType].push_back(timing.m_finishedSeconds - timing.m_startedSeconds);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+bool JobTelemetry::IsTracked(JobTiming const& timing)
+{
+	//Jobs queued before the last Reset(), or run directly by a benchmark without going through OnJobQueued, are ignored
+	return timing.m_queuedSeconds > 0.0 && timing.m_queuedSeconds >= s_resetSeconds;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int JobTelemetry::GetQueueDepth(JobTelemetryType jobType)
+{
+	return std::max(s_numQueued[jobType] - s_numStarted[jobType], 0);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+char const* JobTelemetry::GetName(JobTelemetryType jobType)
+{
+	switch (jobType)
+	{
+		case JOB_TELEMETRY_GENERATION:		return "generation";
+		case JOB_TELEMETRY_DISK_LOAD:		return "diskLoad";
+		case JOB_TELEMETRY_DISK_SAVE:		return "diskSave";
+		default:							return "unknown";
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobTelemetry::Reset()
+{
+	s_resetSeconds = GetCurrentTimeSeconds();
+	for (int typeIndex = 0; typeIndex < NUM_JOB_TELEMETRY_TYPES; typeIndex++)
+	{
+		s_numQueued[typeIndex] = 0;
+		s_numStarted[typeIndex] = 0;
+		s_maxQueueDepth[typeIndex] = 0;
+		s_latencySeconds[typeIndex].clear();
+		s_executeSeconds[typeIndex].clear();
+	}
+	for (int threadIndex = 0; threadIndex < MAX_THREADS; threadIndex++)
+	{
+		s_threadBusyMicroseconds[threadIndex] = 0;
+		s_threadNumJobs[threadIndex] = 0;
+		s_threadJobTypeMask[threadIndex] = 0;
+	}
+	s_numDroppedSamples = 0;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int JobTelemetry::GetThreadIndex()
+{
+	thread_local int t_threadIndex = -1;
+	if (t_threadIndex < 0)
+	{
+		std::lock_guard<std::mutex> lock(s_threadIndexMutex);
+		t_threadIndex = s_numThreads++;
+	}
+	return t_threadIndex;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void JobTelemetry::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("JobTelemetry", JobTelemetry::Event_JobTelemetry);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// JobTelemetry reset=false
+//	Per job type: jobs retrieved, current/max queue depth, queued-to-started latency and execute duration percentiles.
+//	Per worker thread: busy percentage of the wall time since the last reset and the job types it ran.
+//	Worker threads are numbered in the order they first finished a job, not by their JobSystem index.
+bool JobTelemetry::Event_JobTelemetry(EventArgs& args)
+{
+	bool shouldReset = args.GetValue("reset", false);
+	double wallSeconds = GetCurrentTimeSeconds() - s_resetSeconds;
+
+	for (int typeIndex = 0; typeIndex < NUM_JOB_TELEMETRY_TYPES; typeIndex++)
+	{
+		JobTelemetryType jobType = static_cast<JobTelemetryType>(typeIndex);
+		std::vector<double> latencies = s_latencySeconds[typeIndex];
+		std::vector<double> durations = s_executeSeconds[typeIndex];
+		std::sort(latencies.begin(), latencies.end());
+		std::sort(durations.begin(), durations.end());
+
+		PrintToConsole(Stringf("JobTelemetry %-10s: jobs=%i, depth=%i (max %i), latency p50=%.2fms p95=%.2fms max=%.2fms, execute p50=%.2fms p95=%.2fms max=%.2fms",
+			GetName(jobType), (int)latencies.size(), GetQueueDepth(jobType), s_maxQueueDepth[typeIndex].load(),
+			1000.0 * Benchmark::GetPercentile(latencies, 0.5f), 1000.0 * Benchmark::GetPercentile(latencies, 0.95f), 1000.0 * Benchmark::GetPercentile(latencies, 1.f),
+			1000.0 * Benchmark::GetPercentile(durations, 0.5f), 1000.0 * Benchmark::GetPercentile(durations, 0.95f), 1000.0 * Benchmark::GetPercentile(durations, 1.f)),
+			Rgba8(0, 255, 255, 255));
+	}
+
+	int numThreads = std::min(s_numThreads.load(), MAX_THREADS);
+	for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+	{
+		std::string jobTypeNames;
+		for (int typeIndex = 0; typeIndex < NUM_JOB_TELEMETRY_TYPES; typeIndex++)
+		{
+			if (s_threadJobTypeMask[threadIndex] & (1 << typeIndex))
+			{
+				jobTypeNames += (jobTypeNames.empty() ? "" : ",");
+				jobTypeNames += GetName(static_cast<JobTelemetryType>(typeIndex));
+			}
+		}
+
+		double busySeconds = (double)s_threadBusyMicroseconds[threadIndex].load() / 1000000.0;
+		double busyFraction = (wallSeconds > 0.0) ? busySeconds / wallSeconds : 0.0;
+		PrintToConsole(Stringf("JobTelemetry worker %2i: busy=%5.1f%%, idle=%5.1f%%, jobs=%i, types=%s", threadIndex,
+			100.0 * busyFraction, 100.0 * (1.0 - busyFraction), s_threadNumJobs[threadIndex].load(), jobTypeNames.empty() ? "none" : jobTypeNames.c_str()),
+			Rgba8(0, 255, 255, 255));
+	}
+	PrintToConsole(Stringf("JobTelemetry: %.1fs since reset, %i samples dropped", wallSeconds, s_numDroppedSamples), Rgba8(255, 255, 0, 255));
+
+	if (shouldReset)
+	{
+		Reset();
+		PrintToConsole("JobTelemetry: reset", Rgba8(0, 255, 255, 255));
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum JobTelemetryType
+{
+	JOB_TELEMETRY_GENERATION,
+	JOB_TELEMETRY_DISK_LOAD,
+	JOB_TELEMETRY_DISK_SAVE,
+	NUM_JOB_TELEMETRY_TYPES
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Timestamps carried by each chunk job; written by the queuing thread and the worker, read once the world retrieves the job
+struct JobTiming
+{
+	double	m_queuedSeconds = 0.0;
+	double	m_startedSeconds = 0.0;
+	double	m_finishedSeconds = 0.0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Instrumentation for the chunk jobs World pushes through the JobSystem.
+// Per job type: queue depth, queued-to-started latency and execute duration. Per worker thread: busy time and the job types it ran.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class JobTelemetry
+{
+public:
+	static void			OnJobQueued(JobTelemetryType jobType, JobTiming& timing);
+	static void			OnJobStarted(JobTelemetryType jobType, JobTiming& timing);
+	static void			OnJobFinished(JobTelemetryType jobType, JobTiming& timing);
+	static void			OnJobRetrieved(JobTelemetryType jobType, JobTiming const& timing);
+	static int			GetQueueDepth(JobTelemetryType jobType);
+	static char const*	GetName(JobTelemetryType jobType);
+	static void			Reset();
+
+	static void			RegisterCommands();
+	static bool			Event_JobTelemetry(EventArgs& args);
+
+public:
+	static constexpr int MAX_THREADS = 64;
+	static constexpr int MAX_SAMPLES_PER_TYPE = 200000;
+
+private:
+	static bool			IsTracked(JobTiming const& timing);
+	static int			GetThreadIndex();
+
+	static std::atomic<int>		s_numQueued[NUM_JOB_TELEMETRY_TYPES];
+	static std::atomic<int>		s_numStarted[NUM_JOB_TELEMETRY_TYPES];
+	static std::atomic<int>		s_maxQueueDepth[NUM_JOB_TELEMETRY_TYPES];
+	static std::atomic<int64_t>	s_threadBusyMicroseconds[MAX_THREADS];
+	static std::atomic<int>		s_threadNumJobs[MAX_THREADS];
+	static std::atomic<int>		s_threadJobTypeMask[MAX_THREADS];
+	static std::atomic<int>		s_numThreads;
+	static std::mutex			s_threadIndexMutex;
+	static std::atomic<double>	s_resetSeconds;
+
+	//Main thread only, filled as the world retrieves completed jobs
+	static std::vector<double>	s_latencySeconds[NUM_JOB_TELEMETRY_TYPES];
+	static std::vector<double>	s_executeSeconds[NUM_JOB_TELEMETRY_TYPES];
+	static int					s_numDroppedSamples;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------------------------
+// Main_Headless.cpp
+//
+// Entry point for the headless simulation build (GAME_HEADLESS defined).
+// Builds the voxel simulation only: all of Code/Game except App, Game and Main_Windows.
+// Engine dependencies are Core, Math, ThirdParty/Squirrel and Renderer/Camera (the camera is pure math and
+// still positions the world's streaming origin); every other Renderer/Input/Audio/Window header sits behind
+// GAME_HEADLESS or is forward declared. g_theRenderer/g_theInput/g_terrainSpriteSheet stay nullptr and meshes stay on the CPU.
+//
+// Build: the "Headless|x64" configuration of Game.vcxproj (defines GAME_HEADLESS, excludes App, Game and Main_Windows),
+//	or the CMakeLists.txt at the repository root on Linux: cmake -S . -B _headless -DENGINE_CODE_DIR=../Engine/Code
+//
+// Usage: SimpleMiner_Headless [CommandName] [key=value ...]
+//	Runs from the Run/ folder so Data/GameConfig.xml and Saves/ resolve the same way as the game.
+//	With no command name, "HeadlessRun" is fired, which streams chunks around the spawn point.
+//	HeadlessRun frames=600 dt=0.0166 trace=Saves/Traces/Headless.json also captures a Chrome trace of the run.
+//	HeadlessRun csv=Saves/PerfCounters.csv also streams the per-frame perf counters of the run.
+//	HeadlessRun always ends with the JobTelemetry and ChunkLifecycle reports for the run.
+//
+#if defined(GAME_HEADLESS)
+#include "Game/GameCommon.hpp"
+#include "Game/Benchmark.hpp"
+#include "Game/ChunkLifecycle.hpp"
+#include "Game/Flythrough.hpp"
+#include "Game/JobTelemetry.hpp"
+#include "Game/MemoryStats.hpp"
+#include "Game/PerfCounters.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/WorldFingerprint.hpp"
+#include "Game/BlockDef.hpp"
+#include "Game/BlockTemplate.hpp"
+#include "Game/World.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/EventSytem.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Time.hpp"
+#include <thread>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+App*          g_theApp = nullptr;
+Renderer*     g_theRenderer = nullptr;
+InputSystem*  g_theInput = nullptr;
+AudioSystem*  g_theAudio = nullptr;
+Window*		  g_theWindow = nullptr;
+Game*		  g_theGame = nullptr;
+JobSystem*	  g_theJobSystem = nullptr;
+SpriteSheet*  g_terrainSpriteSheet = nullptr;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static bool Event_HeadlessRun(EventArgs& args)
+{
+	int   numFrames = args.GetValue("frames", 600);
+	float deltaSeconds = args.GetValue("dt", 1.f / 60.f);
+	std::string tracePath = args.GetValue("trace", std::string(""));
+	std::string csvPath = args.GetValue("csv", std::string(""));
+
+	if (!tracePath.empty())
+	{
+		Profiler::BeginCapture();
+	}
+	if (!csvPath.empty())
+	{
+		EventArgs csvArgs;
+		csvArgs.SetValue("file", csvPath);
+		PerfCounters::Event_PerfCountersCSV(csvArgs);
+	}
+
+	World* world = new World();
+	double startTime = GetCurrentTimeSeconds();
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		world->Update(deltaSeconds);
+	}
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	if (!tracePath.empty())
+	{
+		Profiler::EndCapture(tracePath);
+	}
+	if (!csvPath.empty())
+	{
+		EventArgs csvArgs;
+		PerfCounters::Event_PerfCountersCSV(csvArgs);
+	}
+
+	int numChunkVerts = (int)PerfCounters::GetValue(PERF_GAUGE_MESH_VERTICES);
+	PrintToConsole(Stringf("HeadlessRun: frames=%i, seconds=%.3f, activeChunks=%i / %i, vertices=%i, memory=%.1f MB (highWater=%.1f MB)", numFrames, elapsedSeconds,
+		(int)world->m_activeChunks.size(), world->m_maxChunks, numChunkVerts,
+		(double)MemoryStats::GetTotalCurrent() / (1024.0 * 1024.0), (double)MemoryStats::GetTotalHighWater() / (1024.0 * 1024.0)));
+
+	//The world reset the telemetry when it configured the job system, so these cover exactly the run
+	EventArgs telemetryArgs;
+	JobTelemetry::Event_JobTelemetry(telemetryArgs);
+	ChunkLifecycle::Event_ChunkLifecycle(telemetryArgs);
+
+	delete world;
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	EventSystemConfig eventSystemConfig;
+	g_theEventSystem = new EventSystem(eventSystemConfig);
+	g_theEventSystem->SubscribeEventCallbackFunction("HeadlessRun", Event_HeadlessRun);
+
+	JobSystemConfig jobSystemConfig;
+	//The world pins worker 0 to disk jobs, so keep at least one generation worker on single-core machines
+	jobSystemConfig.m_numWorkerThreads = (int)std::thread::hardware_concurrency();
+	if (jobSystemConfig.m_numWorkerThreads < 2)
+	{
+		jobSystemConfig.m_numWorkerThreads = 2;
+	}
+	g_theJobSystem = new JobSystem(jobSystemConfig);
+
+	g_theEventSystem->Startup();
+	g_theJobSystem->Startup();
+
+	BlockDef::InitializeBlockDefs();
+	BlockTemplate::InitializeBlockTemplateDefinitions();
+	Benchmark::RegisterCommands();
+	Flythrough::RegisterReplayCommands();
+	ChunkLifecycle::RegisterCommands();
+	JobTelemetry::RegisterCommands();
+	MemoryStats::RegisterCommands();
+	PerfCounters::RegisterCommands();
+	Profiler::RegisterCommands();
+	WorldFingerprint::RegisterCommands();
+
+	//First bare token names the command, every key=value token becomes an event argument
+	std::string commandName = "HeadlessRun";
+	EventArgs args;
+	for (int argIndex = 1; argIndex < argc; argIndex++)
+	{
+		std::string argument = argv[argIndex];
+		size_t equalsIndex = argument.find('=');
+		if (equalsIndex == std::string::npos)
+		{
+			commandName = argument;
+		}
+		else
+		{
+			args.SetValue(argument.substr(0, equalsIndex), argument.substr(equalsIndex + 1));
+		}
+	}
+	FireEvent(commandName, args);
+
+	BlockTemplate::DestroyBlockTemplateDefinitions();
+
+	g_theJobSystem->ShutDown();
+	g_theEventSystem->Shutdown();
+
+	delete g_theJobSystem;
+	g_theJobSystem = nullptr;
+
+	delete g_theEventSystem;
+	g_theEventSystem = nullptr;
+
+	return 0;
+}
+#endif
@@ -0,0 +1,176 @@
+#include "Game/MemoryStats.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/World.hpp"
+#include "Game/Chunks.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::atomic<int64_t>	MemoryStats::s_current[NUM_MEMORY_CATEGORIES] = {};
+std::atomic<int64_t>	MemoryStats::s_highWater[NUM_MEMORY_CATEGORIES] = {};
+std::atomic<int64_t>	MemoryStats::s_totalCurrent = 0;
+std::atomic<int64_t>	MemoryStats::s_totalHighWater = 0;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static double BytesToMB(int64_t numBytes)
+{
+	return (double)numBytes / (1024.0 * 1024.0);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void MemoryStats::Add(MemoryCategory category, int64_t numBytes)
+{
+	if (numBytes == 0)
+	{
+		return;
+	}
+
+	int64_t newValue = (s_current[category] += numBytes);
+	int64_t newTotal = (s_totalCurrent += numBytes);
+	RaiseHighWater(s_highWater[category], newValue);
+	RaiseHighWater(s_totalHighWater, newTotal);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void MemoryStats::Set(MemoryCategory category, int64_t numBytes)
+{
+	int64_t oldValue = s_current[category].exchange(numBytes);
+	int64_t newTotal = (s_totalCurrent += numBytes - oldValue);
+	RaiseHighWater(s_highWater[category], numBytes);
+	RaiseHighWater(s_totalHighWater, newTotal);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void MemoryStats::RaiseHighWater(std::atomic<int64_t>& highWater, int64_t value)
+{
+	int64_t currentHighWater = highWater;
+	while (value > currentHighWater && !highWater.compare_exchange_weak(currentHighWater, value))
+	{
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+char const* MemoryStats::GetName(MemoryCategory category)
+{
+	switch (category)
+	{
+		case MEMORY_CHUNK_BLOCKS:			return "chunkBlocks";
+		case MEMORY_CPU_MESH:				return "cpuMesh";
+		case MEMORY_GPU_MESH:				return "gpuMesh";
+		case MEMORY_NEARBY_CAVES:			return "nearbyCaves";
+		case MEMORY_DIRTY_LIGHT_QUEUE:		return "dirtyLightQueue";
+		case MEMORY_JOB_QUEUES:				return "jobQueues";
+		case MEMORY_COLUMN_CACHE:			return "columnCache";
+		case MEMORY_CAVE_CACHE:				return "caveCache";
+		case MEMORY_PENDING_BLOCK_WRITES:	return "pendingBlockWrites";
+		default:							return "unknown";
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void MemoryStats::ResetHighWater()
+{
+	for (int categoryIndex = 0; categoryIndex < NUM_MEMORY_CATEGORIES; categoryIndex++)
+	{
+		s_highWater[categoryIndex] = s_current[categoryIndex].load();
+	}
+	s_totalHighWater = s_totalCurrent.load();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void MemoryStats::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("MemoryStats", MemoryStats::Event_MemoryStats);
+	g_theEventSystem->SubscribeEventCallbackFunction("MemoryChunks", MemoryStats::Event_MemoryChunks);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// MemoryStats reset=false
+//	Prints current and high-water bytes per category; reset=true then restarts the high-water marks from the current values.
+bool MemoryStats::Event_MemoryStats(EventArgs& args)
+{
+	bool shouldReset = args.GetValue("reset", false);
+
+	for (int categoryIndex = 0; categoryIndex < NUM_MEMORY_CATEGORIES; categoryIndex++)
+	{
+		MemoryCategory category = static_cast<MemoryCategory>(categoryIndex);
+		PrintToConsole(Stringf("MemoryStats %-16s: current=%8.2f MB, highWater=%8.2f MB", GetName(category),
+			BytesToMB(GetCurrent(category)), BytesToMB(GetHighWater(category))), Rgba8(0, 255, 255, 255));
+	}
+	PrintToConsole(Stringf("MemoryStats %-16s: current=%8.2f MB, highWater=%8.2f MB", "total",
+		BytesToMB(GetTotalCurrent()), BytesToMB(GetTotalHighWater())), Rgba8(255, 255, 0, 255));
+
+	if (shouldReset)
+	{
+		ResetHighWater();
+		PrintToConsole("MemoryStats: high-water marks reset", Rgba8(0, 255, 255, 255));
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// MemoryChunks count=20 file=Saves/MemoryChunks.csv
+//	Per-chunk breakdown of the active chunks, largest first. Prints the top count chunks; file= also writes every chunk as CSV.
+bool MemoryStats::Event_MemoryChunks(EventArgs& args)
+{
+	if (g_theGame == nullptr || g_theGame->m_world == nullptr)
+	{
+		PrintToConsole("MemoryChunks: no world is running", Rgba8(255, 0, 0, 255));
+		return false;
+	}
+
+	int numToPrint = args.GetValue("count", 20);
+	std::string filePath = args.GetValue("file", std::string(""));
+
+	struct ChunkMemoryEntry
+	{
+		IntVec2				m_chunkCoords;
+		ChunkMemoryUsage	m_usage;
+		int					m_numVertices = 0;
+	};
+
+	World* world = g_theGame->m_world;
+	std::vector<ChunkMemoryEntry> entries;
+	entries.reserve(world->m_activeChunks.size());
+	for (auto chunkIt = world->m_activeChunks.begin(); chunkIt != world->m_activeChunks.end(); ++chunkIt)
+	{
+		ChunkMemoryEntry entry;
+		entry.m_chunkCoords = chunkIt->first;
+		chunkIt->second->GetMemoryUsage(entry.m_usage);
+		entry.m_numVertices = chunkIt->second->GetChunkMeshVertices();
+		entries.push_back(entry);
+	}
+	std::sort(entries.begin(), entries.end(), [](ChunkMemoryEntry const& a, ChunkMemoryEntry const& b)
+		{
+			return a.m_usage.GetTotalBytes() > b.m_usage.GetTotalBytes();
+		});
+
+	numToPrint = std::min(numToPrint, (int)entries.size());
+	for (int entryIndex = 0; entryIndex < numToPrint; entryIndex++)
+	{
+		ChunkMemoryEntry const& entry = entries[entryIndex];
+		PrintToConsole(Stringf("MemoryChunks (%4i,%4i): total=%7.1f KB, blocks=%6.1f KB, cpuMesh=%6.1f KB (%i verts), gpuMesh=%6.1f KB, caves=%5.1f KB",
+			entry.m_chunkCoords.x, entry.m_chunkCoords.y, (double)entry.m_usage.GetTotalBytes() / 1024.0, (double)entry.m_usage.m_blockBytes / 1024.0,
+			(double)entry.m_usage.m_cpuMeshBytes / 1024.0, entry.m_numVertices, (double)entry.m_usage.m_gpuMeshBytes / 1024.0,
+			(double)entry.m_usage.m_nearbyCavesBytes / 1024.0), Rgba8(0, 255, 255, 255));
+	}
+	PrintToConsole(Stringf("MemoryChunks: %i active chunks, %i initialized", (int)world->m_activeChunks.size(), (int)world->m_initializedChunks.size()),
+		Rgba8(255, 255, 0, 255));
+
+	if (!filePath.empty())
+	{
+		std::string csv = "chunkX,chunkY,totalBytes,blockBytes,cpuMeshBytes,gpuMeshBytes,nearbyCavesBytes,vertices\n";
+		for (int entryIndex = 0; entryIndex < (int)entries.size(); entryIndex++)
+		{
+			ChunkMemoryEntry const& entry = entries[entryIndex];
+			csv += Stringf("%i,%i,%llu,%llu,%llu,%llu,%llu,%i\n", entry.m_chunkCoords.x, entry.m_chunkCoords.y,
+				(unsigned long long)entry.m_usage.GetTotalBytes(), (unsigned long long)entry.m_usage.m_blockBytes,
+				(unsigned long long)entry.m_usage.m_cpuMeshBytes, (unsigned long long)entry.m_usage.m_gpuMeshBytes,
+				(unsigned long long)entry.m_usage.m_nearbyCavesBytes, entry.m_numVertices);
+		}
+
+		std::error_code errorCode;
+		std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), errorCode);
+		std::vector<uint8_t> buffer(csv.begin(), csv.end());
+		bool wasWritten = FileWriteFromBuffer(buffer, filePath);
+		PrintToConsole(Stringf("MemoryChunks: %s %s", wasWritten ? "wrote" : "FAILED to write", filePath.c_str()),
+			wasWritten ? Rgba8(0, 255, 255, 255) : Rgba8(255, 0, 0, 255));
+		return wasWritten;
+	}
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include <atomic>
+#include <cstdint>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum MemoryCategory
+{
+	MEMORY_CHUNK_BLOCKS,		//Chunk::m_blocks of every live chunk, including chunks still queued for load/generation
+	MEMORY_CPU_MESH,			//Chunk::m_cpuMesh capacity
+	MEMORY_GPU_MESH,			//bytes uploaded to each chunk VBO, the buffer only grows
+	MEMORY_NEARBY_CAVES,		//Chunk::m_nearbyCaves, pointers into the cave cache
+	MEMORY_DIRTY_LIGHT_QUEUE,	//World::m_dirtyLightBlocks entries
+	MEMORY_JOB_QUEUES,			//chunk jobs queued but not yet retrieved by the world
+	MEMORY_COLUMN_CACHE,		//shared per-column ground height and climate
+	MEMORY_CAVE_CACHE,			//shared cave paths and their node lists
+	MEMORY_PENDING_BLOCK_WRITES,	//structure blocks waiting for the chunk they spill into
+	NUM_MEMORY_CATEGORIES
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ChunkMemoryUsage
+{
+	size_t	m_blockBytes = 0;
+	size_t	m_cpuMeshBytes = 0;
+	size_t	m_gpuMeshBytes = 0;
+	size_t	m_nearbyCavesBytes = 0;
+
+	size_t	GetTotalBytes() const { return m_blockBytes + m_cpuMeshBytes + m_gpuMeshBytes + m_nearbyCavesBytes; }
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Bytes held by the large per-chunk and per-world structures, kept up to date by the code that grows or frees them.
+// Every category and the total keep a high-water mark so a growing structure shows up even after it has been freed.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class MemoryStats
+{
+public:
+	static void			Add(MemoryCategory category, int64_t numBytes);
+	static void			Set(MemoryCategory category, int64_t numBytes);
+	static int64_t		GetCurrent(MemoryCategory category) { return s_current[category]; }
+	static int64_t		GetHighWater(MemoryCategory category) { return s_highWater[category]; }
+	static int64_t		GetTotalCurrent() { return s_totalCurrent; }
+	static int64_t		GetTotalHighWater() { return s_totalHighWater; }
+	static char const*	GetName(MemoryCategory category);
+	static void			ResetHighWater();
+
+	static void			RegisterCommands();
+	static bool			Event_MemoryStats(EventArgs& args);
+	static bool			Event_MemoryChunks(EventArgs& args);
+
+private:
+	static void			RaiseHighWater(std::atomic<int64_t>& highWater, int64_t value);
+
+	static std::atomic<int64_t>	s_current[NUM_MEMORY_CATEGORIES];
+	static std::atomic<int64_t>	s_highWater[NUM_MEMORY_CATEGORIES];
+	static std::atomic<int64_t>	s_totalCurrent;
+	static std::atomic<int64_t>	s_totalHighWater;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,147 @@
+#include "Game/NoiseTile.hpp"
+#include "ThirdParty/Squirrel/SmoothNoise.hpp"
+#include "ThirdParty/Squirrel/RawNoise.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define NOISE_TILE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+static_assert((CHUNK_SIZE_X % 4) == 0, "Noise tiles evaluate four columns of a row at a time");
+
+#if defined(NOISE_TILE_USE_SSE2)
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Same eight unit gradients (22.5 + 45n degrees), octave offset and output scale as Compute2dPerlinNoise
+static float const s_gradientsX[8] = { +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f, +0.382683432f, +0.923879533f };
+static float const s_gradientsY[8] = { +0.382683432f, +0.923879533f, +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f };
+static float const OCTAVE_OFFSET = 0.636764989593174f;
+static float const PERLIN_2D_NORMALIZER = 1.f / 0.662578106f;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static __m128 SmoothStep3x4(__m128 t)
+{
+	return _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_set1_ps(2.f), t)), t), t);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static __m128 FastFloorx4(__m128 value)
+{
+	//Truncate, then step down by one for negative values, like the scalar FastFloor
+	__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+	return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmplt_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.f)));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static __m128 Compute2dPerlinNoisex4(__m128 posX, __m128 posY, NoiseTileLayer const& layer)
+{
+	__m128 const one = _mm_set1_ps(1.f);
+	__m128 invScale = _mm_set1_ps(1.f / layer.m_scale);
+	__m128 currentX = _mm_mul_ps(posX, invScale);
+	__m128 currentY = _mm_mul_ps(posY, invScale);
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	unsigned int seed = layer.m_seed;
+
+	alignas(16) int cellWestX[4];
+	alignas(16) int cellSouthY[4];
+	alignas(16) float gradientX[4][4];		//[SW, SE, NW, NE][lane]
+	alignas(16) float gradientY[4][4];
+
+	for (unsigned int octaveNum = 0; octaveNum < layer.m_numOctaves; octaveNum++)
+	{
+		__m128 cellMinsX = FastFloorx4(currentX);
+		__m128 cellMinsY = FastFloorx4(currentY);
+		_mm_store_si128(reinterpret_cast<__m128i*>(cellWestX), _mm_cvttps_epi32(cellMinsX));
+		_mm_store_si128(reinterpret_cast<__m128i*>(cellSouthY), _mm_cvttps_epi32(cellMinsY));
+
+		//Lattice hashes stay scalar so they always match whatever Get2dNoiseUint the engine ships
+		for (int lane = 0; lane < 4; lane++)
+		{
+			unsigned int noiseSW = Get2dNoiseUint(cellWestX[lane],     cellSouthY[lane],     seed);
+			unsigned int noiseSE = Get2dNoiseUint(cellWestX[lane] + 1, cellSouthY[lane],     seed);
+			unsigned int noiseNW = Get2dNoiseUint(cellWestX[lane],     cellSouthY[lane] + 1, seed);
+			unsigned int noiseNE = Get2dNoiseUint(cellWestX[lane] + 1, cellSouthY[lane] + 1, seed);
+			gradientX[0][lane] = s_gradientsX[noiseSW & 7];		gradientY[0][lane] = s_gradientsY[noiseSW & 7];
+			gradientX[1][lane] = s_gradientsX[noiseSE & 7];		gradientY[1][lane] = s_gradientsY[noiseSE & 7];
+			gradientX[2][lane] = s_gradientsX[noiseNW & 7];		gradientY[2][lane] = s_gradientsY[noiseNW & 7];
+			gradientX[3][lane] = s_gradientsX[noiseNE & 7];		gradientY[3][lane] = s_gradientsY[noiseNE & 7];
+		}
+
+		//Dot each corner's gradient with the displacement from that corner
+		__m128 fromWestX = _mm_sub_ps(currentX, cellMinsX);
+		__m128 fromEastX = _mm_sub_ps(currentX, _mm_add_ps(cellMinsX, one));
+		__m128 fromSouthY = _mm_sub_ps(currentY, cellMinsY);
+		__m128 fromNorthY = _mm_sub_ps(currentY, _mm_add_ps(cellMinsY, one));
+		__m128 dotSouthWest = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradientX[0]), fromWestX), _mm_mul_ps(_mm_load_ps(gradientY[0]), fromSouthY));
+		__m128 dotSouthEast = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradientX[1]), fromEastX), _mm_mul_ps(_mm_load_ps(gradientY[1]), fromSouthY));
+		__m128 dotNorthWest = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradientX[2]), fromWestX), _mm_mul_ps(_mm_load_ps(gradientY[2]), fromNorthY));
+		__m128 dotNorthEast = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradientX[3]), fromEastX), _mm_mul_ps(_mm_load_ps(gradientY[3]), fromNorthY));
+
+		//Smoothed weighted average of the four dot products
+		__m128 weightEast = SmoothStep3x4(fromWestX);
+		__m128 weightNorth = SmoothStep3x4(fromSouthY);
+		__m128 weightWest = _mm_sub_ps(one, weightEast);
+		__m128 weightSouth = _mm_sub_ps(one, weightNorth);
+		__m128 blendSouth = _mm_add_ps(_mm_mul_ps(weightEast, dotSouthEast), _mm_mul_ps(weightWest, dotSouthWest));
+		__m128 blendNorth = _mm_add_ps(_mm_mul_ps(weightEast, dotNorthEast), _mm_mul_ps(weightWest, dotNorthWest));
+		__m128 blendTotal = _mm_add_ps(_mm_mul_ps(weightSouth, blendSouth), _mm_mul_ps(weightNorth, blendNorth));
+		__m128 noiseThisOctave = _mm_mul_ps(blendTotal, _mm_set1_ps(PERLIN_2D_NORMALIZER));
+
+		totalNoise = _mm_add_ps(totalNoise, _mm_mul_ps(noiseThisOctave, _mm_set1_ps(currentAmplitude)));
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= layer.m_octavePersistence;
+		currentX = _mm_add_ps(_mm_mul_ps(currentX, _mm_set1_ps(layer.m_octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+		currentY = _mm_add_ps(_mm_mul_ps(currentY, _mm_set1_ps(layer.m_octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+		seed++;
+	}
+
+	if (layer.m_renormalize && totalAmplitude > 0.f)
+	{
+		__m128 half = _mm_set1_ps(0.5f);
+		totalNoise = _mm_div_ps(totalNoise, _mm_set1_ps(totalAmplitude));
+		totalNoise = _mm_add_ps(_mm_mul_ps(totalNoise, half), half);
+		totalNoise = SmoothStep3x4(totalNoise);
+		totalNoise = _mm_sub_ps(_mm_mul_ps(totalNoise, _mm_set1_ps(2.f)), one);
+	}
+	return totalNoise;
+}
+#endif
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Compute2dPerlinNoiseTile(float tileMinsX, float tileMinsY, NoiseTileLayer const* layers, int numLayers, int minLocalY, int maxLocalY)
+{
+#if defined(NOISE_TILE_USE_SSE2)
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		__m128 posY = _mm_set1_ps(tileMinsY + float(localY));
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX += 4)
+		{
+			__m128 posX = _mm_set_ps(tileMinsX + float(localX + 3), tileMinsX + float(localX + 2), tileMinsX + float(localX + 1), tileMinsX + float(localX));
+			int columnIndex = localX + (localY << CHUNK_BITS_X);
+			for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+			{
+				_mm_storeu_ps(&layers[layerIndex].m_out_values[columnIndex], Compute2dPerlinNoisex4(posX, posY, layers[layerIndex]));
+			}
+		}
+	}
+#else
+	Compute2dPerlinNoiseTileScalar(tileMinsX, tileMinsY, layers, numLayers, minLocalY, maxLocalY);
+#endif
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Compute2dPerlinNoiseTileScalar(float tileMinsX, float tileMinsY, NoiseTileLayer const* layers, int numLayers, int minLocalY, int maxLocalY)
+{
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		float globalY = tileMinsY + float(localY);
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			float globalX = tileMinsX + float(localX);
+			int columnIndex = localX + (localY << CHUNK_BITS_X);
+			for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+			{
+				NoiseTileLayer const& layer = layers[layerIndex];
+				layer.m_out_values[columnIndex] = Compute2dPerlinNoise(globalX, globalY, layer.m_scale, layer.m_numOctaves,
+					layer.m_octavePersistence, layer.m_octaveScale, layer.m_renormalize, layer.m_seed);
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,27 @@
+#pragma once
+#include "Game/Chunks.hpp"
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// One fractal Perlin layer of a noise tile, with the same parameters as Compute2dPerlinNoise
+struct NoiseTileLayer
+{
+	float			m_scale = 1.f;
+	unsigned int	m_numOctaves = 1;
+	float			m_octavePersistence = 0.5f;
+	float			m_octaveScale = 2.f;
+	bool			m_renormalize = true;
+	unsigned int	m_seed = 0;
+	float*			m_out_values = nullptr;		//CHUNK_BLOCKS_PER_LAYER values, indexed localX + localY * CHUNK_SIZE_X
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Evaluates Compute2dPerlinNoise for every column of a chunk-sized tile whose first column is at (tileMinsX, tileMinsY),
+// four columns per SSE register, for several layers in one pass over the tile.
+// Lattice hashes still come from Get2dNoiseUint, so results match the scalar noise up to float rounding; without SSE2
+// this falls back to Compute2dPerlinNoiseTileScalar, which calls Compute2dPerlinNoise per column.
+// Gradients, octave offset and normalizer are copied from the engine's noise; ColumnCache only uses the tiles after
+// checking them against the linked Compute2dPerlinNoise (ColumnCache::DoNoiseTilesMatchScalarNoise).
+// Only rows [minLocalY, maxLocalY) of the tile are computed, so several workers can split one tile.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Compute2dPerlinNoiseTile(float tileMinsX, float tileMinsY, NoiseTileLayer const* layers, int numLayers, int minLocalY = 0, int maxLocalY = CHUNK_SIZE_Y);
+void Compute2dPerlinNoiseTileScalar(float tileMinsX, float tileMinsY, NoiseTileLayer const* layers, int numLayers, int minLocalY = 0, int maxLocalY = CHUNK_SIZE_Y);
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,246 @@
+#include "Game/OreField.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define ORE_FIELD_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+static_assert((CHUNK_SIZE_X % 4) == 0, "Ore layers evaluate four columns of a row at a time");
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+constexpr unsigned int ORE_PRIME_Y = 198491317;
+constexpr unsigned int ORE_PRIME_Z = 6542989;
+constexpr unsigned int ORE_BIT_NOISE1 = 0xd2a80a3f;
+constexpr unsigned int ORE_BIT_NOISE2 = 0xa884f197;
+constexpr unsigned int ORE_BIT_NOISE3 = 0x6c736f4b;
+constexpr unsigned int ORE_BIT_NOISE4 = 0xb79f3abb;
+constexpr unsigned int ORE_BIT_NOISE5 = 0x1b56c4f5;
+
+//Same odds as rolling coal 5%, then iron 2%, gold 0.5% and diamond 0.1% with each later roll overriding the earlier ones
+constexpr double DIAMOND_CHANCE = 0.001;
+constexpr double GOLD_CHANCE = 0.005 * (1.0 - 0.001);
+constexpr double IRON_CHANCE = 0.02 * (1.0 - 0.005) * (1.0 - 0.001);
+constexpr double COAL_CHANCE = 0.05 * (1.0 - 0.02) * (1.0 - 0.005) * (1.0 - 0.001);
+
+//The top 24 bits of the hash are compared, so the thresholds stay positive in SSE2's signed compares
+constexpr double ORE_ROLL_RANGE = 16777216.0;
+constexpr int DIAMOND_THRESHOLD = int(DIAMOND_CHANCE * ORE_ROLL_RANGE);
+constexpr int GOLD_THRESHOLD = int((DIAMOND_CHANCE + GOLD_CHANCE) * ORE_ROLL_RANGE);
+constexpr int IRON_THRESHOLD = int((DIAMOND_CHANCE + GOLD_CHANCE + IRON_CHANCE) * ORE_ROLL_RANGE);
+constexpr int COAL_THRESHOLD = int((DIAMOND_CHANCE + GOLD_CHANCE + IRON_CHANCE + COAL_CHANCE) * ORE_ROLL_RANGE);
+
+//Thresholds put roughly 5% of stone in coal seams, 2% below z=80 in iron, 1% below z=40 in gold and 1% below z=16 in diamond
+static OreVeinDef const s_oreVeinDefs[NUM_ORE_VEINS] =
+{
+	{ ORE_COAL,		8, 2, CHUNK_SIZE_Z,	0.81f, 0 },
+	{ ORE_IRON,		4, 4, 80,			0.86f, 1 },
+	{ ORE_GOLD,		4, 4, 40,			0.90f, 2 },
+	{ ORE_DIAMOND,	2, 2, 16,			0.94f, 3 },
+};
+static_assert((CHUNK_SIZE_X % 8) == 0 && (CHUNK_SIZE_Y % 8) == 0, "Vein lattice spacings must divide the chunk size");
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int GetOreHash(int globalX, int globalY, int globalZ, unsigned int seed)
+{
+	unsigned int mangledBits = (unsigned int)globalX + ORE_PRIME_Y * (unsigned int)globalY + ORE_PRIME_Z * (unsigned int)globalZ;
+	mangledBits *= ORE_BIT_NOISE1;
+	mangledBits += seed;
+	mangledBits ^= (mangledBits >> 9);
+	mangledBits += ORE_BIT_NOISE2;
+	mangledBits ^= (mangledBits >> 11);
+	mangledBits *= ORE_BIT_NOISE3;
+	mangledBits ^= (mangledBits >> 13);
+	mangledBits += ORE_BIT_NOISE4;
+	mangledBits ^= (mangledBits >> 15);
+	mangledBits *= ORE_BIT_NOISE5;
+	mangledBits ^= (mangledBits >> 17);
+	return mangledBits;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static OreType GetOreTypeForHash(unsigned int hash)
+{
+	int oreRoll = (int)(hash >> 8);
+	return (OreType)((oreRoll < COAL_THRESHOLD) + (oreRoll < IRON_THRESHOLD) + (oreRoll < GOLD_THRESHOLD) + (oreRoll < DIAMOND_THRESHOLD));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+OreType GetOreTypeAt(int globalX, int globalY, int globalZ, unsigned int seed)
+{
+	return GetOreTypeForHash(GetOreHash(globalX, globalY, globalZ, seed));
+}
+#if defined(ORE_FIELD_USE_SSE2)
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Low 32 bits of four 32x32 products; SSE2 has no _mm_mullo_epi32, so multiply the even and odd lanes separately
+static __m128i MultiplyLow32x4(__m128i a, __m128i b)
+{
+	__m128i evenProducts = _mm_mul_epu32(a, b);
+	__m128i oddProducts = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(evenProducts, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(oddProducts, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static __m128i GetOreHashx4(__m128i positionIndices, unsigned int seed)
+{
+	__m128i mangledBits = MultiplyLow32x4(positionIndices, _mm_set1_epi32((int)ORE_BIT_NOISE1));
+	mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)seed));
+	mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 9));
+	mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)ORE_BIT_NOISE2));
+	mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 11));
+	mangledBits = MultiplyLow32x4(mangledBits, _mm_set1_epi32((int)ORE_BIT_NOISE3));
+	mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 13));
+	mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)ORE_BIT_NOISE4));
+	mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 15));
+	mangledBits = MultiplyLow32x4(mangledBits, _mm_set1_epi32((int)ORE_BIT_NOISE5));
+	mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 17));
+	return mangledBits;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static __m128i GetOreTypesForHashesx4(__m128i hashes)
+{
+	//Each passed threshold adds one (compares yield -1, so subtract them)
+	__m128i oreRolls = _mm_srli_epi32(hashes, 8);
+	__m128i oreTypes = _mm_setzero_si128();
+	oreTypes = _mm_sub_epi32(oreTypes, _mm_cmplt_epi32(oreRolls, _mm_set1_epi32(COAL_THRESHOLD)));
+	oreTypes = _mm_sub_epi32(oreTypes, _mm_cmplt_epi32(oreRolls, _mm_set1_epi32(IRON_THRESHOLD)));
+	oreTypes = _mm_sub_epi32(oreTypes, _mm_cmplt_epi32(oreRolls, _mm_set1_epi32(GOLD_THRESHOLD)));
+	oreTypes = _mm_sub_epi32(oreTypes, _mm_cmplt_epi32(oreRolls, _mm_set1_epi32(DIAMOND_THRESHOLD)));
+	return oreTypes;
+}
+#endif
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void ComputeOreLayer(int chunkMinsX, int chunkMinsY, int localZ, unsigned int seed, uint8_t* out_oreTypes, int minLocalY, int maxLocalY)
+{
+#if defined(ORE_FIELD_USE_SSE2)
+	unsigned int layerOffset = ORE_PRIME_Z * (unsigned int)localZ;
+	__m128i laneOffsets = _mm_set_epi32(3, 2, 1, 0);
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		unsigned int rowOffset = layerOffset + ORE_PRIME_Y * (unsigned int)(chunkMinsY + localY);
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX += 4)
+		{
+			__m128i positionIndices = _mm_add_epi32(_mm_set1_epi32((int)(rowOffset + (unsigned int)(chunkMinsX + localX))), laneOffsets);
+			__m128i oreTypes = GetOreTypesForHashesx4(GetOreHashx4(positionIndices, seed));
+
+			//Narrow the four 32-bit types (0..4) to bytes
+			__m128i oreTypeBytes = _mm_packus_epi16(_mm_packs_epi32(oreTypes, oreTypes), _mm_setzero_si128());
+			int packedOreTypes = _mm_cvtsi128_si32(oreTypeBytes);
+			memcpy(&out_oreTypes[localX + (localY << CHUNK_BITS_X)], &packedOreTypes, 4);
+		}
+	}
+#else
+	ComputeOreLayerScalar(chunkMinsX, chunkMinsY, localZ, seed, out_oreTypes, minLocalY, maxLocalY);
+#endif
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void ComputeOreLayerScalar(int chunkMinsX, int chunkMinsY, int localZ, unsigned int seed, uint8_t* out_oreTypes, int minLocalY, int maxLocalY)
+{
+	for (int localY = minLocalY; localY < maxLocalY; localY++)
+	{
+		for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+		{
+			out_oreTypes[localX + (localY << CHUNK_BITS_X)] = GetOreTypeAt(chunkMinsX + localX, chunkMinsY + localY, localZ, seed);
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+OreVeinField::OreVeinField(int chunkMinsX, int chunkMinsY, unsigned int seed)
+{
+	for (int veinIndex = 0; veinIndex < NUM_ORE_VEINS; veinIndex++)
+	{
+		OreVeinDef const& veinDef = s_oreVeinDefs[veinIndex];
+		VeinLattice& lattice = m_lattices[veinIndex];
+		lattice.m_numPointsX = CHUNK_SIZE_X / veinDef.m_latticeSpacingXY + 1;
+		lattice.m_numPointsY = CHUNK_SIZE_Y / veinDef.m_latticeSpacingXY + 1;
+		int numPlanes = (veinDef.m_maxZ - 1) / veinDef.m_latticeSpacingZ + 2;
+		lattice.m_values.resize(lattice.m_numPointsX * lattice.m_numPointsY * numPlanes);
+
+		//Chunk mins are multiples of the spacing, so neighboring chunks hash the same points along their shared edge
+		int latticeMinsX = chunkMinsX / veinDef.m_latticeSpacingXY;
+		int latticeMinsY = chunkMinsY / veinDef.m_latticeSpacingXY;
+		unsigned int veinSeed = seed + veinDef.m_seedOffset;
+		int valueIndex = 0;
+		for (int latticeZ = 0; latticeZ < numPlanes; latticeZ++)
+		{
+			for (int latticeY = 0; latticeY < lattice.m_numPointsY; latticeY++)
+			{
+				for (int latticeX = 0; latticeX < lattice.m_numPointsX; latticeX++)
+				{
+					unsigned int hash = GetOreHash(latticeMinsX + latticeX, latticeMinsY + latticeY, latticeZ, veinSeed);
+					lattice.m_values[valueIndex++] = float(hash >> 8) * (1.f / 16777216.f);
+				}
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void OreVeinField::ComputeLayer(int localZ, uint8_t* out_oreTypes, int minLocalY, int maxLocalY) const
+{
+	memset(&out_oreTypes[minLocalY << CHUNK_BITS_X], ORE_NONE, (maxLocalY - minLocalY) * CHUNK_SIZE_X);
+
+	float blendedPlane[(CHUNK_SIZE_X + 1) * (CHUNK_SIZE_Y + 1)];
+	float weightsXY[CHUNK_SIZE_X > CHUNK_SIZE_Y ? CHUNK_SIZE_X : CHUNK_SIZE_Y];
+	for (int veinIndex = 0; veinIndex < NUM_ORE_VEINS; veinIndex++)
+	{
+		OreVeinDef const& veinDef = s_oreVeinDefs[veinIndex];
+		if (localZ >= veinDef.m_maxZ)
+		{
+			continue;
+		}
+
+		//Blend the two lattice planes around this layer into one
+		VeinLattice const& lattice = m_lattices[veinIndex];
+		int spacingXY = veinDef.m_latticeSpacingXY;
+		int spacingZ = veinDef.m_latticeSpacingZ;
+		int planeSize = lattice.m_numPointsX * lattice.m_numPointsY;
+		int lowerPlaneZ = localZ / spacingZ;
+		float weightZ = SmoothStep3(float(localZ - lowerPlaneZ * spacingZ) / float(spacingZ));
+		float const* lowerPlane = &lattice.m_values[lowerPlaneZ * planeSize];
+		float const* upperPlane = lowerPlane + planeSize;
+		for (int pointIndex = 0; pointIndex < planeSize; pointIndex++)
+		{
+			blendedPlane[pointIndex] = lowerPlane[pointIndex] + (upperPlane[pointIndex] - lowerPlane[pointIndex]) * weightZ;
+		}
+
+		for (int offset = 0; offset < spacingXY; offset++)
+		{
+			weightsXY[offset] = SmoothStep3(float(offset) / float(spacingXY));
+		}
+
+		//Upsample the blended plane to every column of the requested rows
+		for (int localY = minLocalY; localY < maxLocalY; localY++)
+		{
+			int latticeY = localY / spacingXY;
+			float weightY = weightsXY[localY - latticeY * spacingXY];
+			float const* southRow = &blendedPlane[latticeY * lattice.m_numPointsX];
+			float const* northRow = southRow + lattice.m_numPointsX;
+			for (int localX = 0; localX < CHUNK_SIZE_X; localX++)
+			{
+				int latticeX = localX / spacingXY;
+				float weightX = weightsXY[localX - latticeX * spacingXY];
+				float south = southRow[latticeX] + (southRow[latticeX + 1] - southRow[latticeX]) * weightX;
+				float north = northRow[latticeX] + (northRow[latticeX + 1] - northRow[latticeX]) * weightX;
+				float veinNoise = south + (north - south) * weightY;
+				if (veinNoise > veinDef.m_threshold)
+				{
+					out_oreTypes[localX + (localY << CHUNK_BITS_X)] = veinDef.m_oreType;
+				}
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int OreVeinField::GetMaxZ() const
+{
+	int maxZ = 0;
+	for (int veinIndex = 0; veinIndex < NUM_ORE_VEINS; veinIndex++)
+	{
+		maxZ = std::max(maxZ, s_oreVeinDefs[veinIndex].m_maxZ);
+	}
+	return maxZ;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+OreVeinDef const& OreVeinField::GetVeinDef(int veinIndex)
+{
+	return s_oreVeinDefs[veinIndex];
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
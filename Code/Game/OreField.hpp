@@ -0,0 +1,67 @@
+#pragma once
+#include "Game/Chunks.hpp"
+#include <cstdint>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum OreType : uint8_t
+{
+	ORE_NONE,
+	ORE_COAL,
+	ORE_IRON,
+	ORE_GOLD,
+	ORE_DIAMOND,
+	NUM_ORE_TYPES
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Deterministic ore field: each global block position hashes (SquirrelNoise5-style, with our own copy of the mangling so
+// the SSE2 path matches it bit for bit) to one ore type. Rates match the old chained RollRandomChance calls, but any
+// block can be evaluated alone and in any order, so chunks no longer share one ore pattern or depend on fill order.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int	GetOreHash(int globalX, int globalY, int globalZ, unsigned int seed);
+OreType			GetOreTypeAt(int globalX, int globalY, int globalZ, unsigned int seed);
+
+// Ore types of rows [minLocalY, maxLocalY) of the chunk layer at localZ, indexed localX + localY * CHUNK_SIZE_X, four
+// columns per SSE register; entries of other rows are left untouched
+void			ComputeOreLayer(int chunkMinsX, int chunkMinsY, int localZ, unsigned int seed, uint8_t* out_oreTypes, int minLocalY = 0, int maxLocalY = CHUNK_SIZE_Y);
+void			ComputeOreLayerScalar(int chunkMinsX, int chunkMinsY, int localZ, unsigned int seed, uint8_t* out_oreTypes, int minLocalY = 0, int maxLocalY = CHUNK_SIZE_Y);
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// One kind of clustered vein: value noise on a coarse 3D lattice of hashed points, smoothly upsampled, is ore where it
+// rises above the threshold. Flat lattices (large XY spacing, small Z spacing) give seams, even spacings give pockets.
+struct OreVeinDef
+{
+	OreType			m_oreType = ORE_NONE;
+	int				m_latticeSpacingXY = 4;		//must divide CHUNK_SIZE_X and CHUNK_SIZE_Y
+	int				m_latticeSpacingZ = 4;
+	int				m_maxZ = CHUNK_SIZE_Z;		//no vein of this kind at or above this height
+	float			m_threshold = 1.f;
+	unsigned int	m_seedOffset = 0;
+};
+constexpr int NUM_ORE_VEINS = 4;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Vein lattices of one chunk. The constructor hashes the few thousand lattice points the chunk touches; ComputeLayer then
+// only interpolates, so clustered veins cost less per block than hashing every block. Later vein kinds (rarer ores)
+// win where veins overlap, like the later rolls of the old per-block chances. ComputeLayer is const, so the row bands
+// of one chunk share a single field.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class OreVeinField
+{
+public:
+	OreVeinField(int chunkMinsX, int chunkMinsY, unsigned int seed);
+
+	void			ComputeLayer(int localZ, uint8_t* out_oreTypes, int minLocalY = 0, int maxLocalY = CHUNK_SIZE_Y) const;
+	int				GetMaxZ() const;
+
+	static OreVeinDef const& GetVeinDef(int veinIndex);
+
+private:
+	struct VeinLattice
+	{
+		std::vector<float>	m_values;		//indexed latticeX + latticeY * m_numPointsX + latticeZ * m_numPointsX * m_numPointsY
+		int					m_numPointsX = 0;
+		int					m_numPointsY = 0;
+	};
+
+	VeinLattice		m_lattices[NUM_ORE_VEINS];
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
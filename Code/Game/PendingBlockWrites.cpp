@@ -0,0 +1,165 @@
+#include "Game/PendingBlockWrites.hpp"
+#include "Game/MemoryStats.hpp"
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+PendingBlockWrites::~PendingBlockWrites()
+{
+	MemoryStats::Add(MEMORY_PENDING_BLOCK_WRITES, -m_numBytes);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Replaces everything the source recorded earlier for each of these targets. Generation is deterministic, so a source
+// that is regenerated records the same writes again and the store does not grow with every revisit.
+void PendingBlockWrites::SetWrites(IntVec2 const& sourceChunkCoords, PendingBlockWritesByChunk const& writesByTargetChunk)
+{
+	if (writesByTargetChunk.empty())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	int64_t numChangedBytes = 0;
+	for (PendingBlockWritesByChunk::const_iterator targetIt = writesByTargetChunk.begin(); targetIt != writesByTargetChunk.end(); ++targetIt)
+	{
+		std::vector<PendingBlockWrite>& sourceWrites = m_writesByTargetChunk[targetIt->first][sourceChunkCoords];
+		numChangedBytes -= (int64_t)(sourceWrites.size() * sizeof(PendingBlockWrite));
+		sourceWrites = targetIt->second;
+		numChangedBytes += (int64_t)(sourceWrites.size() * sizeof(PendingBlockWrite));
+	}
+
+	m_numBytes += numChangedBytes;
+	MemoryStats::Add(MEMORY_PENDING_BLOCK_WRITES, numChangedBytes);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Appends the writes of every source not yet in inout_appliedSources to out_writes, source chunk by source chunk so the
+// order does not depend on which neighbor finished decorating first, and adds those sources to the mask.
+// A freshly generated target passes an empty mask and gets everything. Returns false if there was nothing new.
+bool PendingBlockWrites::CopyWrites(IntVec2 const& targetChunkCoords, uint8_t& inout_appliedSources, std::vector<PendingBlockWrite>& out_writes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::map<IntVec2, PendingBlockWritesByChunk>::const_iterator targetIt = m_writesByTargetChunk.find(targetChunkCoords);
+	if (targetIt == m_writesByTargetChunk.end())
+	{
+		return false;
+	}
+
+	bool didCopyWrites = false;
+	for (PendingBlockWritesByChunk::const_iterator sourceIt = targetIt->second.begin(); sourceIt != targetIt->second.end(); ++sourceIt)
+	{
+		uint8_t sourceBit = GetSourceBit(targetChunkCoords, sourceIt->first);
+		if ((inout_appliedSources & sourceBit) != 0)
+		{
+			continue;
+		}
+
+		inout_appliedSources |= sourceBit;
+		out_writes.insert(out_writes.end(), sourceIt->second.begin(), sourceIt->second.end());
+		didCopyWrites = true;
+	}
+	return didCopyWrites;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Called once the chunk's blocks and applied mask are on disk. It is loaded rather than regenerated from now on, so the
+// writes it already holds are dropped, and as a source it will not record its writes again, so those are never evicted.
+void PendingBlockWrites::OnChunkSaved(IntVec2 const& chunkCoords, uint8_t appliedSources)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::map<IntVec2, PendingBlockWritesByChunk>::iterator targetIt = m_writesByTargetChunk.find(chunkCoords);
+	if (targetIt != m_writesByTargetChunk.end())
+	{
+		PendingBlockWritesByChunk& writesBySourceChunk = targetIt->second;
+		for (PendingBlockWritesByChunk::iterator sourceIt = writesBySourceChunk.begin(); sourceIt != writesBySourceChunk.end();)
+		{
+			if ((appliedSources & GetSourceBit(chunkCoords, sourceIt->first)) != 0)
+			{
+				PendingBlockWritesByChunk::iterator removedIt = sourceIt++;
+				RemoveWrites(writesBySourceChunk, removedIt);
+			}
+			else
+			{
+				++sourceIt;
+			}
+		}
+		if (writesBySourceChunk.empty())
+		{
+			m_writesByTargetChunk.erase(targetIt);
+		}
+	}
+
+	for (int targetY = chunkCoords.y - 1; targetY <= chunkCoords.y + 1; targetY++)
+	{
+		for (int targetX = chunkCoords.x - 1; targetX <= chunkCoords.x + 1; targetX++)
+		{
+			std::map<IntVec2, PendingBlockWritesByChunk>::const_iterator neighborIt = m_writesByTargetChunk.find(IntVec2(targetX, targetY));
+			if (neighborIt != m_writesByTargetChunk.end() && neighborIt->second.count(chunkCoords) > 0)
+			{
+				m_savedSourceChunks.insert(chunkCoords);
+				return;
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Main thread, once neither chunk is in memory. An unsaved source is regenerated before the target needs its writes
+// again: before the target's light stage if it is in range by then, otherwise it reaches the target as a late write.
+void PendingBlockWrites::EvictWrites(IntVec2 const& targetChunkCoords, IntVec2 const& sourceChunkCoords)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_savedSourceChunks.count(sourceChunkCoords) > 0)
+	{
+		return;
+	}
+
+	std::map<IntVec2, PendingBlockWritesByChunk>::iterator targetIt = m_writesByTargetChunk.find(targetChunkCoords);
+	if (targetIt == m_writesByTargetChunk.end())
+	{
+		return;
+	}
+
+	PendingBlockWritesByChunk::iterator sourceIt = targetIt->second.find(sourceChunkCoords);
+	if (sourceIt == targetIt->second.end())
+	{
+		return;
+	}
+
+	RemoveWrites(targetIt->second, sourceIt);
+	if (targetIt->second.empty())
+	{
+		m_writesByTargetChunk.erase(targetIt);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int PendingBlockWrites::GetNumTargetChunks()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return (int)m_writesByTargetChunk.size();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// One bit per neighbor in the 3x3 around the target, row by row from the south-west; 0 for any other chunk.
+// Block templates are far smaller than a chunk, so a structure never reaches past the neighbors of its own chunk.
+uint8_t PendingBlockWrites::GetSourceBit(IntVec2 const& targetChunkCoords, IntVec2 const& sourceChunkCoords)
+{
+	int offsetX = sourceChunkCoords.x - targetChunkCoords.x;
+	int offsetY = sourceChunkCoords.y - targetChunkCoords.y;
+	if (offsetX < -1 || offsetX > 1 || offsetY < -1 || offsetY > 1 || (offsetX == 0 && offsetY == 0))
+	{
+		return 0;
+	}
+
+	int neighborIndex = (offsetX + 1) + 3 * (offsetY + 1);
+	if (neighborIndex > 4)
+	{
+		neighborIndex--;
+	}
+	return static_cast<uint8_t>(1 << neighborIndex);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Caller holds m_mutex
+void PendingBlockWrites::RemoveWrites(PendingBlockWritesByChunk& writesBySourceChunk, PendingBlockWritesByChunk::iterator sourceIt)
+{
+	int64_t numRemovedBytes = (int64_t)(sourceIt->second.size() * sizeof(PendingBlockWrite));
+	writesBySourceChunk.erase(sourceIt);
+
+	m_numBytes -= numRemovedBytes;
+	MemoryStats::Add(MEMORY_PENDING_BLOCK_WRITES, -numRemovedBytes);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
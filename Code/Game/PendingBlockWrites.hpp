@@ -0,0 +1,47 @@
+#pragma once
+#include "Game/BlockDef.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct PendingBlockWrite
+{
+	uint16_t	m_blockIndex = 0;		//index into the target chunk's m_blocks
+	BlockDefID	m_blockType = 0;
+};
+typedef std::map<IntVec2, std::vector<PendingBlockWrite>> PendingBlockWritesByChunk;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// World-level store of block writes that structures (trees and other block templates) make outside the chunk they are
+// rooted in, keyed by the chunk they land in and then by the neighbor that decorated them. Shared by every generation
+// worker, so each chunk only decides its own structures instead of re-deriving its neighbors'.
+// Readers copy the writes rather than take them: an unsaved target is regenerated from scratch when it comes back into
+// range, while its already decorated neighbors are not, so their writes have to still be here. Each target keeps a mask
+// of the neighbors whose writes its blocks already hold (saved with the chunk), so a neighbor that is regenerated and
+// records the same writes again never puts back blocks the player removed.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class PendingBlockWrites
+{
+public:
+	~PendingBlockWrites();
+
+	void			SetWrites(IntVec2 const& sourceChunkCoords, PendingBlockWritesByChunk const& writesByTargetChunk);
+	bool			CopyWrites(IntVec2 const& targetChunkCoords, uint8_t& inout_appliedSources, std::vector<PendingBlockWrite>& out_writes);
+	void			OnChunkSaved(IntVec2 const& chunkCoords, uint8_t appliedSources);
+	void			EvictWrites(IntVec2 const& targetChunkCoords, IntVec2 const& sourceChunkCoords);
+	int				GetNumTargetChunks();
+
+	static uint8_t	GetSourceBit(IntVec2 const& targetChunkCoords, IntVec2 const& sourceChunkCoords);
+
+private:
+	void			RemoveWrites(PendingBlockWritesByChunk& writesBySourceChunk, PendingBlockWritesByChunk::iterator sourceIt);
+
+	std::mutex												m_mutex;
+	std::map<IntVec2, PendingBlockWritesByChunk>			m_writesByTargetChunk;	//target chunk -> source chunk -> writes
+	std::set<IntVec2>										m_savedSourceChunks;	//sources that are loaded from now on and never record again
+	int64_t													m_numBytes = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,186 @@
+#include "Game/PerfCounters.hpp"
+#include "Game/GameCommon.hpp"
+#include <algorithm>
+#include <filesystem>
+#if !defined(GAME_HEADLESS)
+#include "Engine/Renderer/BitmapFont.hpp"
+#endif
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static char const* const DEFAULT_PERF_CSV_PATH = "Saves/PerfCounters.csv";
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::atomic<int64_t>	PerfCounters::s_values[NUM_PERF_COUNTERS] = {};
+int64_t					PerfCounters::s_valuesAtLastFrame[NUM_PERF_COUNTERS] = {};
+int64_t					PerfCounters::s_history[NUM_PERF_COUNTERS][HISTORY_FRAMES] = {};
+int						PerfCounters::s_historyHead = 0;
+int						PerfCounters::s_numFramesRecorded = 0;
+bool					PerfCounters::s_isOverlayVisible = false;
+std::ofstream			PerfCounters::s_csvStream;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int64_t PerfCounters::GetFrameValue(PerfCounterID counterID, int framesAgo)
+{
+	if (framesAgo < 0 || framesAgo >= HISTORY_FRAMES || framesAgo >= s_numFramesRecorded)
+	{
+		return 0;
+	}
+
+	int historyIndex = (s_historyHead - 1 - framesAgo + HISTORY_FRAMES) % HISTORY_FRAMES;
+	return s_history[counterID][historyIndex];
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+char const* PerfCounters::GetName(PerfCounterID counterID)
+{
+	switch (counterID)
+	{
+		case PERF_COUNTER_CHUNKS_GENERATED:			return "chunksGenerated";
+		case PERF_COUNTER_CHUNKS_LOADED:			return "chunksLoaded";
+		case PERF_COUNTER_CHUNKS_SAVED:				return "chunksSaved";
+		case PERF_COUNTER_MESHES_REBUILT:			return "meshesRebuilt";
+		case PERF_COUNTER_LIGHT_BLOCKS_PROCESSED:	return "lightBlocksProcessed";
+		case PERF_COUNTER_JOBS_QUEUED:				return "jobsQueued";
+		case PERF_COUNTER_JOBS_COMPLETED:			return "jobsCompleted";
+		case PERF_COUNTER_COLUMN_CACHE_HITS:		return "columnCacheHits";
+		case PERF_COUNTER_COLUMN_CACHE_MISSES:		return "columnCacheMisses";
+		case PERF_COUNTER_CAVE_CACHE_HITS:			return "caveCacheHits";
+		case PERF_COUNTER_CAVE_CACHE_MISSES:		return "caveCacheMisses";
+		case PERF_GAUGE_ACTIVE_CHUNKS:				return "activeChunks";
+		case PERF_GAUGE_MESH_VERTICES:				return "meshVertices";
+		case PERF_GAUGE_FRAME_MICROSECONDS:			return "frameMicroseconds";
+		case PERF_GAUGE_GENERATION_QUEUE_DEPTH:		return "generationQueueDepth";
+		case PERF_GAUGE_DISK_QUEUE_DEPTH:			return "diskQueueDepth";
+		default:									return "unknown";
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void PerfCounters::EndFrame(float deltaSeconds)
+{
+	SetGauge(PERF_GAUGE_FRAME_MICROSECONDS, static_cast<int64_t>(deltaSeconds * 1000000.f));
+
+	for (int counterIndex = 0; counterIndex < NUM_PERF_COUNTERS; counterIndex++)
+	{
+		PerfCounterID counterID = static_cast<PerfCounterID>(counterIndex);
+		int64_t value = s_values[counterIndex];
+		s_history[counterIndex][s_historyHead] = IsGauge(counterID) ? value : (value - s_valuesAtLastFrame[counterIndex]);
+		s_valuesAtLastFrame[counterIndex] = value;
+	}
+
+	if (s_csvStream.is_open())
+	{
+		for (int counterIndex = 0; counterIndex < NUM_PERF_COUNTERS; counterIndex++)
+		{
+			s_csvStream << (counterIndex == 0 ? "" : ",") << s_history[counterIndex][s_historyHead];
+		}
+		s_csvStream << "\n";
+	}
+
+	s_historyHead = (s_historyHead + 1) % HISTORY_FRAMES;
+	s_numFramesRecorded++;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void PerfCounters::AddVertsForOverlay(std::vector<Vertex_PCU>& textVerts, std::vector<Vertex_PCU>& barVerts, BitmapFont& font, Vec2 const& topLeft)
+{
+#if defined(GAME_HEADLESS)
+	UNUSED(textVerts);
+	UNUSED(barVerts);
+	UNUSED(font);
+	UNUSED(topLeft);
+#else
+	constexpr float ROW_HEIGHT = 26.f;
+	constexpr float LABEL_WIDTH = 330.f;
+	constexpr float BAR_WIDTH = 1.5f;
+	constexpr float BAR_MAX_HEIGHT = 20.f;
+	Rgba8 const backgroundColor(0, 0, 0, 120);
+	Rgba8 const barColor(255, 200, 0, 220);
+
+	int numFrames = std::min(s_numFramesRecorded, HISTORY_FRAMES);
+	for (int counterIndex = 0; counterIndex < NUM_PERF_COUNTERS; counterIndex++)
+	{
+		PerfCounterID counterID = static_cast<PerfCounterID>(counterIndex);
+		float rowTop = topLeft.y - ROW_HEIGHT * float(counterIndex);
+		float rowBottom = rowTop - BAR_MAX_HEIGHT;
+		float graphLeft = topLeft.x + LABEL_WIDTH;
+
+		int64_t maxValue = 1;
+		for (int framesAgo = 0; framesAgo < numFrames; framesAgo++)
+		{
+			maxValue = std::max(maxValue, GetFrameValue(counterID, framesAgo));
+		}
+
+		std::string label = Stringf("%s %lld (max %lld)", GetName(counterID), (long long)GetFrameValue(counterID), (long long)maxValue);
+		AABB2 labelBounds(Vec2(topLeft.x, rowTop), Vec2(graphLeft, rowTop));
+		font.AddVertsForTextInBox2D(textVerts, labelBounds, 14.f, label, Rgba8(255, 255, 255, 255), 0.8f, Vec2(0.f, 1.f), TextDrawMode::OVERRUN, 9999);
+
+		//Oldest frame on the left, newest on the right
+		AABB2 graphBounds(Vec2(graphLeft, rowBottom), Vec2(graphLeft + BAR_WIDTH * float(HISTORY_FRAMES), rowTop));
+		AddVertsForOverlayQuad(barVerts, graphBounds, backgroundColor);
+		for (int framesAgo = 0; framesAgo < numFrames; framesAgo++)
+		{
+			float barHeight = BAR_MAX_HEIGHT * float(GetFrameValue(counterID, framesAgo)) / float(maxValue);
+			float barRight = graphBounds.m_maxs.x - BAR_WIDTH * float(framesAgo);
+			AddVertsForOverlayQuad(barVerts, AABB2(Vec2(barRight - BAR_WIDTH, rowBottom), Vec2(barRight, rowBottom + barHeight)), barColor);
+		}
+	}
+#endif
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void PerfCounters::AddVertsForOverlayQuad(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color)
+{
+	Vec2 bottomLeft = bounds.m_mins;
+	Vec2 topRight = bounds.m_maxs;
+	Vec2 bottomRight(topRight.x, bottomLeft.y);
+	Vec2 topLeft(bottomLeft.x, topRight.y);
+
+	verts.push_back(Vertex_PCU(bottomLeft, color));
+	verts.push_back(Vertex_PCU(bottomRight, color));
+	verts.push_back(Vertex_PCU(topRight, color));
+
+	verts.push_back(Vertex_PCU(bottomLeft, color));
+	verts.push_back(Vertex_PCU(topRight, color));
+	verts.push_back(Vertex_PCU(topLeft, color));
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void PerfCounters::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("PerfCounters", PerfCounters::Event_PerfCounters);
+	g_theEventSystem->SubscribeEventCallbackFunction("PerfCountersCSV", PerfCounters::Event_PerfCountersCSV);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// PerfCounters
+//	Toggles the rolling histogram overlay.
+bool PerfCounters::Event_PerfCounters(EventArgs& args)
+{
+	UNUSED(args);
+	s_isOverlayVisible = !s_isOverlayVisible;
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// PerfCountersCSV file=Saves/PerfCounters.csv
+//	First call starts streaming one row per frame, second call closes the file.
+bool PerfCounters::Event_PerfCountersCSV(EventArgs& args)
+{
+	if (s_csvStream.is_open())
+	{
+		s_csvStream.close();
+		PrintToConsole("PerfCountersCSV: stopped", Rgba8(0, 255, 255, 255));
+		return true;
+	}
+
+	std::string filePath = args.GetValue("file", std::string(DEFAULT_PERF_CSV_PATH));
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), errorCode);
+	s_csvStream.open(filePath, std::ios::out | std::ios::trunc);
+	if (!s_csvStream.is_open())
+	{
+		PrintToConsole(Stringf("PerfCountersCSV: could not open %s", filePath.c_str()), Rgba8(255, 0, 0, 255));
+		return false;
+	}
+
+	for (int counterIndex = 0; counterIndex < NUM_PERF_COUNTERS; counterIndex++)
+	{
+		s_csvStream << (counterIndex == 0 ? "" : ",") << GetName(static_cast<PerfCounterID>(counterIndex));
+	}
+	s_csvStream << "\n";
+	PrintToConsole(Stringf("PerfCountersCSV: streaming to %s, run PerfCountersCSV again to stop", filePath.c_str()), Rgba8(0, 255, 255, 255));
+	return true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
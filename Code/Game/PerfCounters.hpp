@@ -0,0 +1,75 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class BitmapFont;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+enum PerfCounterID
+{
+	//Counters: bumped by the subsystem doing the work, history stores the amount per frame
+	PERF_COUNTER_CHUNKS_GENERATED,
+	PERF_COUNTER_CHUNKS_LOADED,
+	PERF_COUNTER_CHUNKS_SAVED,
+	PERF_COUNTER_MESHES_REBUILT,
+	PERF_COUNTER_LIGHT_BLOCKS_PROCESSED,
+	PERF_COUNTER_JOBS_QUEUED,
+	PERF_COUNTER_JOBS_COMPLETED,
+	PERF_COUNTER_COLUMN_CACHE_HITS,
+	PERF_COUNTER_COLUMN_CACHE_MISSES,
+	PERF_COUNTER_CAVE_CACHE_HITS,
+	PERF_COUNTER_CAVE_CACHE_MISSES,
+
+	//Gauges: a running value, history stores the value at the end of each frame
+	PERF_GAUGE_ACTIVE_CHUNKS,
+	PERF_GAUGE_MESH_VERTICES,
+	PERF_GAUGE_FRAME_MICROSECONDS,
+	PERF_GAUGE_GENERATION_QUEUE_DEPTH,
+	PERF_GAUGE_DISK_QUEUE_DEPTH,
+
+	NUM_PERF_COUNTERS
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Process-wide registry of counters that subsystems bump incrementally from any thread.
+// EndFrame() snapshots them into a rolling per-frame history used by the overlay and the CSV stream.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class PerfCounters
+{
+public:
+	static void			Increment(PerfCounterID counterID, int64_t amount = 1) { s_values[counterID] += amount; }
+	static void			SetGauge(PerfCounterID counterID, int64_t value) { s_values[counterID] = value; }
+	static int64_t		GetValue(PerfCounterID counterID) { return s_values[counterID]; }
+	static int64_t		GetFrameValue(PerfCounterID counterID, int framesAgo = 0);
+	static char const*	GetName(PerfCounterID counterID);
+	static bool			IsGauge(PerfCounterID counterID) { return counterID >= PERF_GAUGE_ACTIVE_CHUNKS; }
+
+	static void			EndFrame(float deltaSeconds);
+	static bool			IsOverlayVisible() { return s_isOverlayVisible; }
+	static void			AddVertsForOverlay(std::vector<Vertex_PCU>& textVerts, std::vector<Vertex_PCU>& barVerts, BitmapFont& font, Vec2 const& topLeft);
+
+	static void			RegisterCommands();
+	static bool			Event_PerfCounters(EventArgs& args);
+	static bool			Event_PerfCountersCSV(EventArgs& args);
+
+public:
+	static constexpr int HISTORY_FRAMES = 240;
+
+private:
+	static void			AddVertsForOverlayQuad(std::vector<Vertex_PCU>& verts, AABB2 const& bounds, Rgba8 const& color);
+
+	static std::atomic<int64_t>	s_values[NUM_PERF_COUNTERS];
+	static int64_t				s_valuesAtLastFrame[NUM_PERF_COUNTERS];
+	static int64_t				s_history[NUM_PERF_COUNTERS][HISTORY_FRAMES];
+	static int					s_historyHead;
+	static int					s_numFramesRecorded;
+	static bool					s_isOverlayVisible;
+	static std::ofstream		s_csvStream;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
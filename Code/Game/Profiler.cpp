@@ -0,0 +1,148 @@
+#include "Game/Profiler.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <filesystem>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static constexpr int MAX_PROFILE_EVENTS = 2000000;
+static char const* const DEFAULT_TRACE_PATH = "Saves/Traces/Trace.json";
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+std::atomic<bool>				Profiler::s_isCapturing = false;
+std::mutex						Profiler::s_eventsMutex;
+std::vector<ProfileEvent>		Profiler::s_events;
+std::map<std::thread::id, int>	Profiler::s_threadIndices;
+std::thread::id					Profiler::s_mainThreadId;
+double							Profiler::s_captureStartSeconds = 0.0;
+int								Profiler::s_numDroppedEvents = 0;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Profiler::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("ProfilerTrace", Profiler::Event_ProfilerTrace);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// ProfilerTrace file=Saves/Traces/Trace.json
+//	First call starts capturing, second call stops and writes the Chrome trace file.
+bool Profiler::Event_ProfilerTrace(EventArgs& args)
+{
+	if (!IsCapturing())
+	{
+		BeginCapture();
+		PrintToConsole("ProfilerTrace: capture started, run ProfilerTrace again to write the trace", Rgba8(0, 255, 255, 255));
+		return true;
+	}
+
+	std::string filePath = args.GetValue("file", std::string(DEFAULT_TRACE_PATH));
+	bool wasWritten = EndCapture(filePath);
+	PrintToConsole(Stringf("ProfilerTrace: %s %s", wasWritten ? "wrote" : "FAILED to write", filePath.c_str()),
+		wasWritten ? Rgba8(0, 255, 255, 255) : Rgba8(255, 0, 0, 255));
+	return wasWritten;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Profiler::BeginCapture()
+{
+	std::lock_guard<std::mutex> lock(s_eventsMutex);
+	s_events.clear();
+	s_events.reserve(65536);
+	s_numDroppedEvents = 0;
+	s_mainThreadId = std::this_thread::get_id();
+	s_captureStartSeconds = GetCurrentTimeSeconds();
+	s_isCapturing = true;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+bool Profiler::EndCapture(std::string const& filePath)
+{
+	s_isCapturing = false;
+
+	std::string json;
+	{
+		std::lock_guard<std::mutex> lock(s_eventsMutex);
+		json.reserve(64 + s_events.size() * 96);
+		json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		for (auto threadIt = s_threadIndices.begin(); threadIt != s_threadIndices.end(); ++threadIt)
+		{
+			std::string threadName = (threadIt->first == s_mainThreadId) ? std::string("Main") : Stringf("Worker %i", threadIt->second);
+			json += Stringf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%i,\"args\":{\"name\":\"%s\"}},\n", threadIt->second, threadName.c_str());
+		}
+
+		for (int eventIndex = 0; eventIndex < (int)s_events.size(); eventIndex++)
+		{
+			ProfileEvent const& event = s_events[eventIndex];
+			json += Stringf("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f},\n",
+				event.m_name, event.m_threadIndex, event.m_startMicroseconds, event.m_durationMicroseconds);
+		}
+
+		json += Stringf("{\"name\":\"droppedEvents\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":0,\"args\":{\"count\":%i}}\n]}\n", s_numDroppedEvents);
+		s_events.clear();
+		s_events.shrink_to_fit();
+	}
+
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), errorCode);
+	std::vector<uint8_t> buffer(json.begin(), json.end());
+	return FileWriteFromBuffer(buffer, filePath);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+double Profiler::GetCaptureMicroseconds()
+{
+	return (GetCurrentTimeSeconds() - s_captureStartSeconds) * 1000000.0;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void Profiler::AddEvent(char const* name, double startMicroseconds, double durationMicroseconds)
+{
+	int threadIndex = GetThreadIndex();
+
+	std::lock_guard<std::mutex> lock(s_eventsMutex);
+	if (!IsCapturing())
+	{
+		return;
+	}
+	if ((int)s_events.size() >= MAX_PROFILE_EVENTS)
+	{
+		s_numDroppedEvents++;
+		return;
+	}
+
+	ProfileEvent event;
+	event.m_name = name;
+	event.m_startMicroseconds = startMicroseconds;
+	event.m_durationMicroseconds = durationMicroseconds;
+	event.m_threadIndex = threadIndex;
+	s_events.push_back(event);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+int Profiler::GetThreadIndex()
+{
+	thread_local int t_threadIndex = -1;
+	if (t_threadIndex < 0)
+	{
+		std::lock_guard<std::mutex> lock(s_eventsMutex);
+		std::thread::id threadId = std::this_thread::get_id();
+		auto threadIt = s_threadIndices.find(threadId);
+		if (threadIt == s_threadIndices.end())
+		{
+			threadIt = s_threadIndices.insert(std::make_pair(threadId, (int)s_threadIndices.size())).first;
+		}
+		t_threadIndex = threadIt->second;
+	}
+	return t_threadIndex;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+ProfileScope::ProfileScope(char const* name)
+	:m_name(name)
+{
+	if (Profiler::IsCapturing())
+	{
+		m_startMicroseconds = Profiler::GetCaptureMicroseconds();
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+ProfileScope::~ProfileScope()
+{
+	if (m_startMicroseconds >= 0.0 && Profiler::IsCapturing())
+	{
+		Profiler::AddEvent(m_name, m_startMicroseconds, Profiler::GetCaptureMicroseconds() - m_startMicroseconds);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Scoped timing markers written out as a Chrome trace-event file (chrome://tracing or ui.perfetto.dev).
+// Scopes on the same thread nest by time, so the viewer shows them as a hierarchy per thread.
+// While no trace is being captured a marker costs one atomic load.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(scopeName) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(scopeName)
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ProfileEvent
+{
+	char const* m_name = nullptr;		//must be a string literal, only the pointer is stored
+	double		m_startMicroseconds = 0.0;
+	double		m_durationMicroseconds = 0.0;
+	int			m_threadIndex = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class Profiler
+{
+public:
+	static void			RegisterCommands();
+	static bool			Event_ProfilerTrace(EventArgs& args);
+
+	static void			BeginCapture();
+	static bool			EndCapture(std::string const& filePath);
+	static bool			IsCapturing() { return s_isCapturing.load(std::memory_order_relaxed); }
+	static double		GetCaptureMicroseconds();
+	static void			AddEvent(char const* name, double startMicroseconds, double durationMicroseconds);
+
+private:
+	static int			GetThreadIndex();
+
+	static std::atomic<bool>				s_isCapturing;
+	static std::mutex						s_eventsMutex;
+	static std::vector<ProfileEvent>		s_events;
+	static std::map<std::thread::id, int>	s_threadIndices;
+	static std::thread::id					s_mainThreadId;
+	static double							s_captureStartSeconds;
+	static int								s_numDroppedEvents;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class ProfileScope
+{
+public:
+	ProfileScope(char const* name);
+	~ProfileScope();
+
+private:
+	char const* m_name = nullptr;
+	double		m_startMicroseconds = -1.0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+#pragma once
+#include "Game/MemoryStats.hpp"
+#include "Game/PerfCounters.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Thread-safe map from a key to an immutable value that is computed once and then shared by every generation worker.
+// Callers compute a value outside the lock after Find misses, then Insert it. Values are handed out as shared pointers, so
+// trimming the least recently used entries never frees data a worker still reads. If two workers miss on the same key at
+// once, the first Insert wins and both get its value.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+class SharedLRUCache
+{
+public:
+	typedef size_t (*GetValueBytesFunction)(ValueType const& value);
+
+	SharedLRUCache(int maxEntries, MemoryCategory memoryCategory, PerfCounterID hitCounterID, PerfCounterID missCounterID, GetValueBytesFunction getValueBytes);
+	~SharedLRUCache();
+
+	std::shared_ptr<ValueType const>	Find(KeyType const& key);
+	std::shared_ptr<ValueType const>	Insert(KeyType const& key, std::shared_ptr<ValueType const> const& value);
+	int									GetNumEntries();
+	void								Clear();
+
+private:
+	struct CacheEntry
+	{
+		std::shared_ptr<ValueType const>	m_value;
+		uint64_t							m_lastUsedTick = 0;
+		size_t								m_numBytes = 0;
+	};
+
+	void								EvictLeastRecentlyUsed();
+
+	int									m_maxEntries = 0;
+	MemoryCategory						m_memoryCategory = NUM_MEMORY_CATEGORIES;
+	PerfCounterID						m_hitCounterID = NUM_PERF_COUNTERS;
+	PerfCounterID						m_missCounterID = NUM_PERF_COUNTERS;
+	GetValueBytesFunction				m_getValueBytes = nullptr;
+	std::mutex							m_mutex;
+	std::map<KeyType, CacheEntry>		m_entries;
+	uint64_t							m_tick = 0;
+	int64_t								m_numBytes = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+SharedLRUCache<KeyType, ValueType>::SharedLRUCache(int maxEntries, MemoryCategory memoryCategory, PerfCounterID hitCounterID, PerfCounterID missCounterID, GetValueBytesFunction getValueBytes)
+	:m_maxEntries(std::max(maxEntries, 16)), m_memoryCategory(memoryCategory), m_hitCounterID(hitCounterID), m_missCounterID(missCounterID), m_getValueBytes(getValueBytes)
+{
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+SharedLRUCache<KeyType, ValueType>::~SharedLRUCache()
+{
+	Clear();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+std::shared_ptr<ValueType const> SharedLRUCache<KeyType, ValueType>::Find(KeyType const& key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto entryIt = m_entries.find(key);
+	if (entryIt == m_entries.end())
+	{
+		PerfCounters::Increment(m_missCounterID);
+		return nullptr;
+	}
+
+	entryIt->second.m_lastUsedTick = ++m_tick;
+	PerfCounters::Increment(m_hitCounterID);
+	return entryIt->second.m_value;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+std::shared_ptr<ValueType const> SharedLRUCache<KeyType, ValueType>::Insert(KeyType const& key, std::shared_ptr<ValueType const> const& value)
+{
+	size_t numValueBytes = m_getValueBytes(*value);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto insertResult = m_entries.insert(std::make_pair(key, CacheEntry()));
+	CacheEntry& entry = insertResult.first->second;
+	if (insertResult.second)
+	{
+		entry.m_value = value;
+		entry.m_numBytes = numValueBytes;
+		m_numBytes += (int64_t)numValueBytes;
+		MemoryStats::Add(m_memoryCategory, (int64_t)numValueBytes);
+	}
+	entry.m_lastUsedTick = ++m_tick;
+	std::shared_ptr<ValueType const> result = entry.m_value;
+
+	if ((int)m_entries.size() > m_maxEntries)
+	{
+		EvictLeastRecentlyUsed();
+	}
+	return result;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+int SharedLRUCache<KeyType, ValueType>::GetNumEntries()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return (int)m_entries.size();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename KeyType, typename ValueType>
+void SharedLRUCache<KeyType, ValueType>::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	MemoryStats::Add(m_memoryCategory, -m_numBytes);
+	m_numBytes = 0;
+	m_entries.clear();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Caller holds m_mutex. Drops the oldest quarter in one pass so the selection is paid once per many inserts.
+template <typename KeyType, typename ValueType>
+void SharedLRUCache<KeyType, ValueType>::EvictLeastRecentlyUsed()
+{
+	std::vector<uint64_t> lastUsedTicks;
+	lastUsedTicks.reserve(m_entries.size());
+	for (auto entryIt = m_entries.begin(); entryIt != m_entries.end(); ++entryIt)
+	{
+		lastUsedTicks.push_back(entryIt->second.m_lastUsedTick);
+	}
+
+	int numToEvict = std::max((int)m_entries.size() - (3 * m_maxEntries) / 4, 1);
+	std::nth_element(lastUsedTicks.begin(), lastUsedTicks.begin() + (numToEvict - 1), lastUsedTicks.end());
+	uint64_t evictAtOrBelowTick = lastUsedTicks[numToEvict - 1];
+
+	int64_t numEvictedBytes = 0;
+	for (auto entryIt = m_entries.begin(); entryIt != m_entries.end();)
+	{
+		if (entryIt->second.m_lastUsedTick <= evictAtOrBelowTick)
+		{
+			numEvictedBytes += (int64_t)entryIt->second.m_numBytes;
+			entryIt = m_entries.erase(entryIt);
+		}
+		else
+		{
+			++entryIt;
+		}
+	}
+	m_numBytes -= numEvictedBytes;
+	MemoryStats::Add(m_memoryCategory, -numEvictedBytes);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
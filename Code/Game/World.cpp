@@ -2,12 +2,28 @@
 #include "Engine/Core/vertexUtils.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/Vec4.hpp"
-#include "Engine/Renderer/BitmapFont.hpp"
-#include "Game/App.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/ChunkLifecycle.hpp"
+#include "Game/CaveCache.hpp"
+#include "Game/ColumnCache.hpp"
+#include "Game/Flythrough.hpp"
+#include "Game/MemoryStats.hpp"
+#include "Game/PendingBlockWrites.hpp"
+#include "Game/PerfCounters.hpp"
+#include "Game/Profiler.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/XmlUtils.hpp"
-#include "Engine/Core/DebugRenderSystem.hpp"
 #include "ThirdParty/Squirrel/SmoothNoise.hpp"
+#if !defined(GAME_HEADLESS)
+#include "Game/App.hpp"
+#include "Engine/Core/DebugRenderSystem.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/ConstantBuffer.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#endif
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 #include <sstream>  
 #include <iomanip>  
@@ -28,26 +44,77 @@ struct MinecraftGameConstants
 static const int k_mincecraftGameConstantsSlot = 5;
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
-World::World()
+World::World(bool configureJobSystem)
+	:m_configuresJobSystem(configureJobSystem)
 {
 	LoadGameConfig();
+#if !defined(GAME_HEADLESS)
 	InitializeShader();
+#endif
 	SetScreenCamera();
 	SetWorldCamera();
 	SetInitialCameraPosition();
 	SetChunkConstantsValues();
+#if !defined(GAME_HEADLESS)
 	CreateConstantBufferForMinecraftConstants();
+#endif
+
+	//Benchmark worlds are filled by hand and must not steal the running world's worker threads
+	if (!m_configuresJobSystem)
+	{
+		return;
+	}
 
 	g_theJobSystem->ClearCompletedJobs();
+	JobTelemetry::Reset();
+	ChunkLifecycle::Reset();
 	g_theJobSystem->SetThreadJobType(0, DISK_JOB_TYPE);
 	for (int jobThreadId = 1; jobThreadId < g_theJobSystem->GetNumThreads(); jobThreadId++)
 	{
 		g_theJobSystem->SetThreadJobType(jobThreadId, CHUNK_GENERATION_JOB_TYPE);
 	}
+
+	//With enough workers, keep one off the terrain stage so the cheap later stages never wait behind a terrain backlog
+	if (g_theJobSystem->GetNumThreads() >= 3)
+	{
+		g_theJobSystem->SetThreadJobType(1, CHUNK_GENERATION_JOB_TYPE & ~CHUNK_TERRAIN_JOB_TYPE);
+	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 World::~World()
 {
+	delete m_flythroughRecording;
+	m_flythroughRecording = nullptr;
+
+	if (!m_configuresJobSystem)
+	{
+		DeactivateAllChunks();
+
+		//Benchmark worlds queue no jobs, so chunks they generated but never activated can be freed right away
+		for (std::map<IntVec2, Chunk*>::iterator chunkIt = m_initializedChunks.begin(); chunkIt != m_initializedChunks.end(); chunkIt++)
+		{
+			Chunk*& chunk = chunkIt->second;
+			if (chunk)
+			{
+				delete chunk;
+				chunk = nullptr;
+			}
+		}
+		m_initializedChunks.clear();
+
+#if !defined(GAME_HEADLESS)
+		delete m_gameCBO;
+#endif
+		m_gameCBO = nullptr;
+		delete m_columnCache;
+		m_columnCache = nullptr;
+		delete m_caveCache;
+		m_caveCache = nullptr;
+		delete m_pendingBlockWrites;
+		m_pendingBlockWrites = nullptr;
+		return;
+	}
+
 	g_theJobSystem->ClearQueuedJobs();
 	g_theJobSystem->WaitUntilCurrentJobsCompletion();
 	g_theJobSystem->ClearCompletedJobs();
@@ -100,12 +167,24 @@ World::~World()
 		g_theJobSystem->SetThreadJobType(jobThreadId, DEFAULT_JOB_ID);
 	}
 
+#if !defined(GAME_HEADLESS)
 	delete m_gameCBO;
+#endif
 	m_gameCBO = nullptr;
+	delete m_columnCache;
+	m_columnCache = nullptr;
+	delete m_caveCache;
+	m_caveCache = nullptr;
+	delete m_pendingBlockWrites;
+	m_pendingBlockWrites = nullptr;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::Update(float deltaSeconds)
 {
+	PROFILE_SCOPE("World::Update");
+	Vec3 frameStartCamPosition = m_camPosition;
+	EulerAngles frameStartCamOrientation = m_camOrientation;
+
 	bool isChunkActivated = ActivateNearestMissingChunk();
 
 	if (!isChunkActivated)
@@ -113,14 +192,33 @@ void World::Update(float deltaSeconds)
 		DeactivateFurthestChunk();
 	}
 	CheckForCompletedJobs();
+	QueueReadyGenerationStages();
 	CheckChunksForMeshUpdate();
 	PerformRaycast();
 	HandleInput();
 	UpdateDayCycle(deltaSeconds);
 	ProcessDirtyLighting();
 	UpdateWorldCamera(deltaSeconds);
+
+	if (m_flythroughRecording != nullptr)
+	{
+		m_flythroughRecording->RecordFrame(deltaSeconds, frameStartCamPosition, frameStartCamOrientation, m_frameActions, static_cast<uint8_t>(m_blockTypeToAdd));
+	}
+	m_frameActions = FLYTHROUGH_ACTION_NONE;
+
+	//Benchmark worlds share the process-wide counters but only the live world advances their frame history
+	if (m_configuresJobSystem)
+	{
+		PerfCounters::SetGauge(PERF_GAUGE_ACTIVE_CHUNKS, (int64_t)m_activeChunks.size());
+		PerfCounters::SetGauge(PERF_GAUGE_GENERATION_QUEUE_DEPTH, JobTelemetry::GetQueueDepth(JOB_TELEMETRY_GENERATION));
+		PerfCounters::SetGauge(PERF_GAUGE_DISK_QUEUE_DEPTH, JobTelemetry::GetQueueDepth(JOB_TELEMETRY_DISK_LOAD) + JobTelemetry::GetQueueDepth(JOB_TELEMETRY_DISK_SAVE));
+		PerfCounters::EndFrame(deltaSeconds);
+		MemoryStats::Set(MEMORY_DIRTY_LIGHT_QUEUE, (int64_t)(m_dirtyLightBlocks.size() * sizeof(BlockIterator)));
+		MemoryStats::Set(MEMORY_JOB_QUEUES, m_jobQueueBytes);
+	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::Render()
 {
 	g_theRenderer->BeginCamera(m_worldCamera);
@@ -138,6 +236,7 @@ void World::Render()
 	AddUI();
 	g_theRenderer->EndCamera(m_screenTextCamera);
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::SetScreenCamera()
 {
@@ -148,7 +247,11 @@ void World::SetScreenCamera()
 void World::SetWorldCamera()
 {
 	m_worldCamera.m_mode = Camera::eMode_Perspective;
-	m_worldCamera.SetPerspectiveView(g_theWindow->m_config.m_clientAspect, 60.0f, 0.1f, 1000.0f);
+	float clientAspect = 2.f;
+#if !defined(GAME_HEADLESS)
+	clientAspect = g_theWindow->m_config.m_clientAspect;
+#endif
+	m_worldCamera.SetPerspectiveView(clientAspect, 60.0f, 0.1f, 1000.0f);
 	Vec3 Ibasis(0.f, 0.f, 1.f);
 	Vec3 JBasis(-1.f, 0.f, 0.f);
 	Vec3 Kbasis(0.f, 1.f, 0.f);
@@ -157,6 +260,7 @@ void World::SetWorldCamera()
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::UpdateWorldCamera(float deltaSeconds)
 {
+	PROFILE_SCOPE("World::UpdateWorldCamera");
 	UpdateCameraKeyboardControls(deltaSeconds);
 	m_worldCamera.SetTransform(m_camPosition, m_camOrientation);
 }
@@ -169,6 +273,11 @@ void World::UpdateCameraKeyboardControls(float deltaSeconds)
 
 	m_velocity = Vec3(0.f, 0.f, 0.f);
 
+#if defined(GAME_HEADLESS)
+	UNUSED(MOVE_SPEED);
+	UNUSED(TURN_RATE);
+	UNUSED(MOUSE_SPEED);
+#else
 	if (g_theInput->IsKeyDown('W'))
 	{
 		Vec3 forward = Vec3(1.f, 0.f, 0.f);
@@ -240,6 +349,7 @@ void World::UpdateCameraKeyboardControls(float deltaSeconds)
 	Vec2 cursorDelta = g_theInput->GetCursorClientDelta();
 	m_camOrientation.m_yawDegrees -= cursorDelta.x * MOUSE_SPEED;
 	m_camOrientation.m_pitchDegrees += cursorDelta.y * MOUSE_SPEED;
+#endif
 
 	m_camOrientation.m_pitchDegrees = GetClamped(m_camOrientation.m_pitchDegrees, -85.f, 85.f);
 	m_camOrientation.m_rollDegrees = GetClamped(m_camOrientation.m_rollDegrees, -45.f, 45.f);
@@ -247,6 +357,7 @@ void World::UpdateCameraKeyboardControls(float deltaSeconds)
 	m_camPosition += m_velocity * deltaSeconds;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::AddCameraCompass()
 {
 	std::vector<Vertex_PCU> verts;
@@ -301,13 +412,8 @@ void World::AddUI()
 	textFont->AddVertsForTextInBox2D(textVerts, bounds, 20.f, infoLine1, Rgba8(255, 255, 0, 255), 0.8f, Vec2(0.f, 1.f), TextDrawMode::OVERRUN, 9999);
 	
 	int numChunks = (int)m_activeChunks.size();
-	int numChunkVerts = 0;
-	int numBlocks = 0;
-	for (auto iter = m_activeChunks.begin(); iter != m_activeChunks.end(); ++iter)
-	{
-		numChunkVerts += iter->second->GetChunkMeshVertices();
-		numBlocks += iter->second->GetNumBlocks();
-	}
+	int numChunkVerts = (int)PerfCounters::GetValue(PERF_GAUGE_MESH_VERTICES);
+	int numBlocks = numChunks * CHUNK_BLOCKS_TOTAL;
 
 	std::string infoLine2 = Stringf("chunks=%i / %i, Blocks=%i, vertices=%i, xyz=(%i,%i,%i), ypr=(%i,%i,%i), frameMS=%i (%i FPS) \n"
 	, numChunks, m_maxChunks, numBlocks, (int)numChunkVerts, (int)m_camPosition.x, (int)m_camPosition.y,
@@ -326,9 +432,18 @@ void World::AddUI()
 	AABB2 bounds3(Vec2(15.f, 750.f), Vec2(1500.f, 750.f));
 	textFont->AddVertsForTextInBox2D(textVerts, bounds3, 18.f, infoLine3, Rgba8(0, 255, 255, 255), 0.8f, Vec2(0.f, 1.f), TextDrawMode::OVERRUN, 9999);
 
+	if (PerfCounters::IsOverlayVisible())
+	{
+		std::vector<Vertex_PCU> barVerts;
+		PerfCounters::AddVertsForOverlay(textVerts, barVerts, *textFont, Vec2(15.f, 720.f));
+		g_theRenderer->BindTexture(nullptr);
+		g_theRenderer->DrawVertexArray((int)barVerts.size(), barVerts.data());
+	}
+
 	g_theRenderer->BindTexture(&textFont->GetTexture());
 	g_theRenderer->DrawVertexArray((int)textVerts.size(), textVerts.data());
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::RandomizeChunks()
 {
@@ -352,16 +467,24 @@ void World::ActivateNewChunk(const IntVec2& chunkCoords)
 	m_initializedChunks.erase(chunkIt);
 	m_initiliazedChunksMutex.unlock();
 
-	chunk->m_status = ChunkState::ACTIVE;
+	chunk->SetStatus(ChunkState::ACTIVE);
 	m_activeChunks[chunkCoords] = chunk;
 
 	LinkChunkToNeighbors(chunk);
 
 	chunk->InitializeLighting();
+
+	//Structures of neighbors that decorated after this chunk's light stage or load copied its pending blocks
+	std::vector<PendingBlockWrite> pendingWrites;
+	if (GetPendingBlockWrites()->CopyWrites(chunkCoords, chunk->m_appliedSpillSources, pendingWrites))
+	{
+		ApplyPendingBlockWritesToActiveChunk(chunk, pendingWrites);
+	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::DeactivateFurthestChunk()
 {
+	PROFILE_SCOPE("World::DeactivateFurthestChunk");
 	if (m_activeChunks.empty())
 		return;
 
@@ -392,9 +515,12 @@ void World::DeactivateFurthestChunk()
 	if (furthestDistanceSquared != 0.f)
 	{
 		Chunk* chunkToDeactivate = furthestChunkIt->second;
+		IntVec2 deactivatedCoords = furthestChunkIt->first;
 		chunkToDeactivate->DisconnectFromNeighbors();
 		m_activeChunks.erase(furthestChunkIt);
 		delete chunkToDeactivate;
+
+		EvictPendingBlockWritesAround(deactivatedCoords);
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -413,6 +539,7 @@ void World::AddDebugDrawVertsForAllChunks(std::vector<Vertex_PCU>& verts)
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::RenderDebugDrawChunk()
 {
 	if (m_debugDrawChunk)
@@ -426,6 +553,7 @@ void World::RenderDebugDrawChunk()
 		g_theRenderer->SetRasterizerModes(RasterizerMode::SOLID_CULL_BACK);
 	}
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::ToggleDebugDrawChunk()
 {
@@ -435,6 +563,19 @@ void World::ToggleDebugDrawChunk()
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::HandleInput()
 {
+	PROFILE_SCOPE("World::HandleInput");
+	//Inputs fed in by FlythroughReplay, applied at the same point in the frame as the mouse buttons below
+	if (m_replayActions & FLYTHROUGH_ACTION_DIG)
+	{
+		OnDiggingOfBlock();
+	}
+	if (m_replayActions & FLYTHROUGH_ACTION_PLACE)
+	{
+		OnPlacingOfBlock(static_cast<BlockDefID>(m_blockTypeToAdd));
+	}
+	m_replayActions = FLYTHROUGH_ACTION_NONE;
+
+#if !defined(GAME_HEADLESS)
 	if (g_theInput->WasKeyJustPressed(KEYCODE_F1))
 	{
 		ToggleDebugDrawChunk();
@@ -443,11 +584,17 @@ void World::HandleInput()
 	if (g_theInput->WasKeyJustPressed(KEYCODE_LEFT_MOUSE))
 	{
 		OnDiggingOfBlock();
+		m_frameActions |= FLYTHROUGH_ACTION_DIG;
 	}
 
 	if (g_theInput->WasKeyJustPressed(KEYCODE_RIGHT_MOUSE))
 	{
 		OnPlacingOfBlock(static_cast<BlockDefID>(m_blockTypeToAdd));
+		m_frameActions |= FLYTHROUGH_ACTION_PLACE;
+		if (m_placeBlockAtCurrentPos)
+		{
+			m_frameActions |= FLYTHROUGH_ACTION_PLACE_AT_CAMERA;
+		}
 	}
 
 	if (g_theInput->WasKeyJustPressed(KEYCODE_F8))
@@ -508,6 +655,7 @@ void World::HandleInput()
 	{
 		m_debugDisableSky = !m_debugDisableSky;
 	}
+#endif
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::LoadGameConfig()
@@ -532,8 +680,14 @@ void World::LoadGameConfig()
 	m_debugStepLightPropagation =   ParseXmlAttribute(*rootElement, "debugStepLightPropagation", m_debugStepLightPropagation);
 	m_debugDisableWorldShader =     ParseXmlAttribute(*rootElement, "debugStepLightPropagation", m_debugDisableWorldShader);
 	m_worldSeed =					ParseXmlAttribute(*rootElement, "worldSeed",				 m_worldSeed);
+	m_useNoiseTiles =				ParseXmlAttribute(*rootElement, "useNoiseTiles",			 m_useNoiseTiles);
+	m_climateLatticeSpacing =		ParseXmlAttribute(*rootElement, "climateLatticeSpacing",	 m_climateLatticeSpacing);
+	m_useOreVeins =					ParseXmlAttribute(*rootElement, "oreVeins",					 m_useOreVeins);
+	m_useWormCaves =				ParseXmlAttribute(*rootElement, "wormCaves",				 m_useWormCaves);
+	m_spawnGenerationBands =		ParseXmlAttribute(*rootElement, "spawnGenerationBands",		 m_spawnGenerationBands);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::InitializeShader()
 {
  	std::string shaderName = "Data/Shaders/World";
@@ -549,12 +703,46 @@ void World::InitializeShader()
 		}
 	}
 }
+#endif
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+ColumnCache* World::GetColumnCache()
+{
+	//Created on first use so benchmarks can still change m_worldSeed after constructing the world
+	if (m_columnCache == nullptr)
+	{
+		ColumnCacheConfig columnConfig;
+		columnConfig.m_worldSeed = static_cast<unsigned int>(m_worldSeed);
+		columnConfig.m_useNoiseTiles = m_useNoiseTiles;
+		columnConfig.m_climateLatticeSpacing = m_climateLatticeSpacing;
+		m_columnCache = new ColumnCache(columnConfig);
+	}
+	return m_columnCache;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+CaveCache* World::GetCaveCache()
+{
+	if (m_caveCache == nullptr)
+	{
+		m_caveCache = new CaveCache(Chunk::GetWorldCaveSeedForWorldSeed(static_cast<unsigned int>(m_worldSeed)));
+	}
+	return m_caveCache;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+PendingBlockWrites* World::GetPendingBlockWrites()
+{
+	if (m_pendingBlockWrites == nullptr)
+	{
+		m_pendingBlockWrites = new PendingBlockWrites();
+	}
+	return m_pendingBlockWrites;
+}
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 int World::GetWorldSeed() const
 {
 	return m_worldSeed;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::RenderChunk()
 {
 	CopyDataToCBOAndBindIt();
@@ -574,9 +762,11 @@ void World::RenderChunk()
 	Shader* defaultShader = g_theRenderer->CreateShaderOrGetFromFile("Default");
 	g_theRenderer->BindShader(defaultShader);
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::CheckChunksForMeshUpdate()
 {	
+	PROFILE_SCOPE("World::CheckChunksForMeshUpdate");
 	Chunk* nearestChunks[10] = {};
 	float nearestDistances[10] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
 
@@ -585,6 +775,7 @@ void World::CheckChunksForMeshUpdate()
 		if (chunk) {
 
 			if (!chunk->m_isChunkDirty || !chunk->HasAllValidNeighbours()) continue;
+			chunk->RecordLifecycleEvent(CHUNK_LIFECYCLE_NEIGHBORS_READY);
 
 			Vec3 chunkCenter = chunk->GetChunkCenter();
 
@@ -719,6 +910,7 @@ IntVec2 World::GetChunkCoordinatesForWorldPosition(Vec3 const& pos) const
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 bool World::ActivateNearestMissingChunk()
 {
+	PROFILE_SCOPE("World::ActivateNearestMissingChunk");
 // 	if (m_activeChunks.size() >= m_maxChunks)
 // 		return false;
 
@@ -766,6 +958,28 @@ bool World::DoesChunkExist(const IntVec2& chunkCoords)
 	return m_activeChunks.find(chunkCoords) != m_activeChunks.end();
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+void World::GetMissingChunksInActivationRange(std::vector<IntVec2>& out_missingChunkCoords) const
+{
+	out_missingChunkCoords.clear();
+	IntVec2 playerChunkCoords = GetChunkCoordinatesForWorldPosition(m_camPosition);
+	IntVec2 neighborhoodMinChunkCoords = playerChunkCoords - IntVec2(m_maxChunkRadiusX, m_maxChunkRadiusY);
+	IntVec2 neighborhoodMaxChunkCoords = playerChunkCoords + IntVec2(m_maxChunkRadiusX, m_maxChunkRadiusY);
+	Vec2 playerWorldPos(m_camPosition.x, m_camPosition.y);
+
+	for (int chunkY = neighborhoodMinChunkCoords.y; chunkY <= neighborhoodMaxChunkCoords.y; chunkY++)
+	{
+		for (int chunkX = neighborhoodMinChunkCoords.x; chunkX <= neighborhoodMaxChunkCoords.x; chunkX++)
+		{
+			IntVec2 chunkCoords(chunkX, chunkY);
+			Vec2 chunkCenterWorldPos = Chunk::GetChunkCenterXYForChunkCoords(chunkCoords);
+			if (GetDistance2D(chunkCenterWorldPos, playerWorldPos) < m_chunkActivationRange && m_activeChunks.find(chunkCoords) == m_activeChunks.end())
+			{
+				out_missingChunkCoords.push_back(chunkCoords);
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::DeactivateAllChunks()
 {
 	std::vector<Chunk*> chunksToDeactivate;
@@ -800,6 +1014,7 @@ void World::DeactivateChunk(Chunk* chunk)
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::ProcessDirtyLighting()
 {
+	PROFILE_SCOPE("World::ProcessDirtyLighting");
 	while (!m_dirtyLightBlocks.empty())
 	{
 		BlockIterator front = m_dirtyLightBlocks.front();
@@ -808,6 +1023,8 @@ void World::ProcessDirtyLighting()
 		
 		if (block)
 		{
+			m_numLightRecomputes++;
+			PerfCounters::Increment(PERF_COUNTER_LIGHT_BLOCKS_PROCESSED);
 			block->SetIsBlockLightDirty(false);
 			uint8_t currentIndoorLightInfluence = block->GetIndoorLightInfluence();
 			uint8_t computedIndoorLightInfluence = ComputeIndoorLightInfluence(front);
@@ -833,6 +1050,7 @@ void World::MarkLightingDirty(const BlockIterator& blockIter)
 
 	block.SetIsBlockLightDirty(true);
 	m_dirtyLightBlocks.push_back(blockIter);
+	m_numLightQueuePushes++;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::MarkLightingDirtyIfNotOpaque(const BlockIterator& blockIter)
@@ -1131,6 +1349,7 @@ uint8_t World::GetHighestIndoorLightInfluenceAmongNeighbours(const BlockIterator
 	return maxIndoorLightInfluence;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::CopyDataToCBOAndBindIt() const
 {
 	MinecraftGameConstants gameConstants;
@@ -1147,17 +1366,18 @@ void World::CopyDataToCBOAndBindIt() const
 	g_theRenderer->CopyCPUtoGPU(&gameConstants, sizeof(MinecraftGameConstants), m_gameCBO);
 	g_theRenderer->BindConstantBuffer(k_mincecraftGameConstantsSlot, m_gameCBO);
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::UpdateDayCycle(float deltaSeconds)
 {
+	PROFILE_SCOPE("World::UpdateDayCycle");
+	m_currentWorldTimeScaleAccelerationFactor = 1.0f;
+#if !defined(GAME_HEADLESS)
 	if (g_theInput->IsKeyDown('Y'))
 	{
 		m_currentWorldTimeScaleAccelerationFactor = 10000.0f / m_worldTimeScale; // acceleration factor when Y is pressed (50x faster)
 	}
-	else
-	{
-		m_currentWorldTimeScaleAccelerationFactor = 1.0f;
-	}
+#endif
 
 	m_worldTime += (deltaSeconds * m_worldTimeScale * m_currentWorldTimeScaleAccelerationFactor) / (60.f * 60.f * 24.f);
 
@@ -1351,6 +1571,7 @@ GameRaycastResult3D World::RaycastVsWorld(const Vec3& start, const Vec3& directi
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::PerformRaycast()
 {
+	PROFILE_SCOPE("World::PerformRaycast");
 	if (!m_freezeRaycast)
 	{
 		m_cameraStart = m_camPosition;
@@ -1360,6 +1581,7 @@ void World::PerformRaycast()
 	m_raycastResult = RaycastVsWorld(m_cameraStart, m_cameraForward, m_raycastDistance);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::RenderRaycast()
 {
 	std::vector<Vertex_PCU> verts;
@@ -1396,6 +1618,7 @@ void World::RenderRaycast()
 		g_theRenderer->DrawVertexArray(int(verts.size()), verts.data());
 	}
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::AddVertsForRaycastImpactedFaces(std::vector<Vertex_PCU>& verts)
 {
@@ -1449,22 +1672,63 @@ void World::AddVertsForRaycastImpactedFaces(std::vector<Vertex_PCU>& verts)
 	}
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+static int64_t GetChunkJobBytes(Job* job)
+{
+	if ((job->m_jobType & CHUNK_GENERATION_JOB_TYPE) != 0)
+	{
+		return (int64_t)sizeof(ChunkGenerationJob);
+	}
+	if (dynamic_cast<ChunkDiskLoadJob*>(job) != nullptr)
+	{
+		return (int64_t)sizeof(ChunkDiskLoadJob);
+	}
+	return (int64_t)sizeof(ChunkDiskSaveJob);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::CheckForCompletedJobs()
 {
+	PROFILE_SCOPE("World::CheckForCompletedJobs");
 	Job* completedJob = g_theJobSystem->RetrieveCompletedJobs();
 
 	while (completedJob)
 	{
-		if (completedJob->m_jobType == CHUNK_GENERATION_JOB_TYPE)
+		if ((completedJob->m_jobType & CHUNK_GENERATION_JOB_TYPE) != 0)
 		{
 			ChunkGenerationJob* chunkJob = (ChunkGenerationJob*)completedJob;
 			if (chunkJob)
 			{
+				JobTelemetry::OnJobRetrieved(JOB_TELEMETRY_GENERATION, chunkJob->m_timing);
 				Chunk* chunk = chunkJob->m_chunk;
 
-				if (chunk && chunk->m_status == ChunkState::ACTIVATING_GENERATE_COMPLETE)
+				//Earlier row bands of a split stage must not touch the chunk; the band that completed the stage frees it for the next
+				if (chunk && chunkJob->m_completesStage)
 				{
-					ActivateNewChunk(chunk->GetChunkCoordinates());
+					chunk->m_isGenerationStageQueued = false;
+
+					//Active neighbors are past their own light stage, so the trees this chunk spilled into them go in now, unless
+					//they already hold this chunk's trees from an earlier visit and may have had leaves dug out since
+					if (chunkJob->m_stage == GENERATION_STAGE_DECORATE)
+					{
+						IntVec2 chunkCoords = chunk->GetChunkCoordinates();
+						std::vector<PendingBlockWrite> pendingWrites;
+						for (int neighborY = chunkCoords.y - 1; neighborY <= chunkCoords.y + 1; neighborY++)
+						{
+							for (int neighborX = chunkCoords.x - 1; neighborX <= chunkCoords.x + 1; neighborX++)
+							{
+								std::map<IntVec2, Chunk*>::iterator neighborIt = m_activeChunks.find(IntVec2(neighborX, neighborY));
+								pendingWrites.clear();
+								if (neighborIt != m_activeChunks.end() && GetPendingBlockWrites()->CopyWrites(neighborIt->first, neighborIt->second->m_appliedSpillSources, pendingWrites))
+								{
+									ApplyPendingBlockWritesToActiveChunk(neighborIt->second, pendingWrites);
+								}
+							}
+						}
+					}
+
+					if (chunk->m_status == ChunkState::ACTIVATING_GENERATE_COMPLETE)
+					{
+						ActivateNewChunk(chunk->GetChunkCoordinates());
+					}
 				}
 			}
 		}
@@ -1473,6 +1737,7 @@ void World::CheckForCompletedJobs()
 			ChunkDiskLoadJob* loadJob = dynamic_cast<ChunkDiskLoadJob*>(completedJob);
 			if (loadJob) 
 			{
+				JobTelemetry::OnJobRetrieved(JOB_TELEMETRY_DISK_LOAD, loadJob->m_timing);
 				Chunk* chunk = loadJob->m_chunk;
 
 				if (chunk && chunk->m_status == ChunkState::ACTIVATING_LOAD_COMPLETE)
@@ -1483,6 +1748,7 @@ void World::CheckForCompletedJobs()
 			else // It must have been a save job then
 			{
 				ChunkDiskSaveJob* saveJob = dynamic_cast<ChunkDiskSaveJob*>(completedJob);
+				JobTelemetry::OnJobRetrieved(JOB_TELEMETRY_DISK_SAVE, saveJob->m_timing);
 				Chunk* chunk = saveJob->m_chunk;
 
 				if (chunk && chunk->m_status == ChunkState::DEACTIVATING_SAVE_COMPLETE)
@@ -1492,6 +1758,8 @@ void World::CheckForCompletedJobs()
 			}
 		}
 
+		PerfCounters::Increment(PERF_COUNTER_JOBS_COMPLETED);
+		m_jobQueueBytes -= GetChunkJobBytes(completedJob);
 		delete completedJob;
 		completedJob = g_theJobSystem->RetrieveCompletedJobs();
 	}
@@ -1524,13 +1792,190 @@ void World::InitializeChunk(IntVec2 const& coords)
 	if (newChunk->CanBeLoadedFromFile()) 
 	{
 		ChunkDiskLoadJob* newChunkLoadJob = new ChunkDiskLoadJob(newChunk);
+		newChunk->SetStatus(ChunkState::ACTIAVTING_QUEUED_LOAD);
+		JobTelemetry::OnJobQueued(JOB_TELEMETRY_DISK_LOAD, newChunkLoadJob->m_timing);
 		g_theJobSystem->QueueJob(newChunkLoadJob);
+		PerfCounters::Increment(PERF_COUNTER_JOBS_QUEUED);
+		m_jobQueueBytes += GetChunkJobBytes(newChunkLoadJob);
 	}
 	else 
 	{
-		ChunkGenerationJob* newChunkGenJob = new ChunkGenerationJob(newChunk);
-		g_theJobSystem->QueueJob(newChunkGenJob);
+		//Chunks around the camera gate the first playable frame, so split their rows across several workers
+		int numBands = 1;
+		IntVec2 camChunkCoords = Chunk::GetChunkCoordinatesForWorldPosition(m_camPosition);
+		if (abs(coords.x - camChunkCoords.x) <= 1 && abs(coords.y - camChunkCoords.y) <= 1)
+		{
+			numBands = std::max(1, std::min(m_spawnGenerationBands, CHUNK_SIZE_Y));
+		}
+		if (numBands > 1)
+		{
+			newChunk->PrepareGenerationBands(numBands);
+		}
+
+		//Only the terrain stage is queued here; QueueReadyGenerationStages queues the rest as neighbors catch up
+		newChunk->SetStatus(ChunkState::ACTIVATING_QUEUED_GENERATE);
+		newChunk->m_isGenerationStageQueued = true;
+		for (int bandIndex = 0; bandIndex < numBands; bandIndex++)
+		{
+			ChunkGenerationJob* newChunkGenJob = new ChunkGenerationJob(newChunk, GENERATION_STAGE_TERRAIN, bandIndex, numBands);
+			JobTelemetry::OnJobQueued(JOB_TELEMETRY_GENERATION, newChunkGenJob->m_timing);
+			g_theJobSystem->QueueJob(newChunkGenJob);
+			PerfCounters::Increment(PERF_COUNTER_JOBS_QUEUED);
+			m_jobQueueBytes += GetChunkJobBytes(newChunkGenJob);
+		}
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Main thread only. Writes blocks other chunks' structures left for an active chunk, like placed blocks: only into air,
+// with the sky and light updates and the neighbor mesh dirtying a placed block gets. The chunk now differs from what
+// generation gives it, so it is marked for saving; writing it releases its records.
+void World::ApplyPendingBlockWritesToActiveChunk(Chunk* chunk, std::vector<PendingBlockWrite> const& pendingWrites)
+{
+	static BlockDefID air = BlockDef::GetBlockDefIDByName("air");
+	for (int writeIndex = 0; writeIndex < (int)pendingWrites.size(); writeIndex++)
+	{
+		PendingBlockWrite const& pendingWrite = pendingWrites[writeIndex];
+		Block* block = chunk->GetBlock(pendingWrite.m_blockIndex);
+		if (block->GetTypeID() != air)
+		{
+			continue;
+		}
+
+		block->SetTypeID(pendingWrite.m_blockType);
+		BlockIterator blockIter(chunk, pendingWrite.m_blockIndex);
+		chunk->ProcessLightingForAddedBlock(blockIter);
+		MarkNeighbouringChunksAndBlocksAsDirty(blockIter);
+		chunk->SetChunkToDirty();
+		chunk->m_needsSaving = true;
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Main thread only. Drops the writes between a chunk that just left memory and each neighbor that is not in memory
+// either, so the store follows the chunks around the player instead of everything explored this session.
+void World::EvictPendingBlockWritesAround(IntVec2 const& chunkCoords)
+{
+	if (m_pendingBlockWrites == nullptr)
+	{
+		return;
+	}
+
+	m_initiliazedChunksMutex.lock();
+	for (int neighborY = chunkCoords.y - 1; neighborY <= chunkCoords.y + 1; neighborY++)
+	{
+		for (int neighborX = chunkCoords.x - 1; neighborX <= chunkCoords.x + 1; neighborX++)
+		{
+			IntVec2 neighborCoords(neighborX, neighborY);
+			if (neighborCoords == chunkCoords || m_activeChunks.count(neighborCoords) > 0 || m_initializedChunks.count(neighborCoords) > 0)
+			{
+				continue;
+			}
+
+			m_pendingBlockWrites->EvictWrites(chunkCoords, neighborCoords);
+			m_pendingBlockWrites->EvictWrites(neighborCoords, chunkCoords);
+		}
+	}
+	m_initiliazedChunksMutex.unlock();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct GenerationStageCandidate
+{
+	float	m_distanceSquared = 0.f;
+	Chunk*	m_chunk = nullptr;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsGenerationStageCandidateCloser(GenerationStageCandidate const& candidateA, GenerationStageCandidate const& candidateB)
+{
+	return candidateA.m_distanceSquared < candidateB.m_distanceSquared;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Queues the next stage of every generating chunk that has none in flight and whose neighbors have finished the stages
+// it depends on, nearest to the camera first, so stages of different chunks overlap across the workers
+void World::QueueReadyGenerationStages()
+{
+	PROFILE_SCOPE("World::QueueReadyGenerationStages");
+	Vec2 camPositionXY(m_camPosition.x, m_camPosition.y);
+	std::vector<GenerationStageCandidate> candidates;
+
+	m_initiliazedChunksMutex.lock();
+	for (std::map<IntVec2, Chunk*>::const_iterator chunkIt = m_initializedChunks.begin(); chunkIt != m_initializedChunks.end(); ++chunkIt)
+	{
+		Chunk* chunk = chunkIt->second;
+		if (chunk->m_wasLoadedFromDisk || chunk->m_isGenerationStageQueued)
+		{
+			continue;
+		}
+
+		int numStagesDone = chunk->m_numGenerationStagesDone;
+		if (numStagesDone >= NUM_GENERATION_STAGES)
+		{
+			continue;
+		}
+
+		ChunkGenerationStageDef const& stageDef = GetChunkGenerationStageDef(ChunkGenerationStage(numStagesDone));
+		if (AreNeighborGenerationStagesDone(chunkIt->first, stageDef.m_numNeighborStagesRequired))
+		{
+			GenerationStageCandidate candidate;
+			candidate.m_distanceSquared = GetDistanceSquared2D(Chunk::GetChunkCenterXYForChunkCoords(chunkIt->first), camPositionXY);
+			candidate.m_chunk = chunk;
+			candidates.push_back(candidate);
+		}
+	}
+	m_initiliazedChunksMutex.unlock();
+
+	std::sort(candidates.begin(), candidates.end(), IsGenerationStageCandidateCloser);
+	for (int candidateIndex = 0; candidateIndex < (int)candidates.size(); candidateIndex++)
+	{
+		Chunk* chunk = candidates[candidateIndex].m_chunk;
+		ChunkGenerationStage stage = ChunkGenerationStage((int)chunk->m_numGenerationStagesDone);
+		chunk->m_isGenerationStageQueued = true;
+
+		ChunkGenerationJob* stageJob = new ChunkGenerationJob(chunk, stage);
+		JobTelemetry::OnJobQueued(JOB_TELEMETRY_GENERATION, stageJob->m_timing);
+		g_theJobSystem->QueueJob(stageJob);
+		PerfCounters::Increment(PERF_COUNTER_JOBS_QUEUED);
+		m_jobQueueBytes += GetChunkJobBytes(stageJob);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Caller holds m_initiliazedChunksMutex. Active and loaded neighbors count as fully generated. A missing neighbor only
+// holds the chunk back while it is inside the activation range, since it will be generated soon; beyond it, it never is.
+bool World::AreNeighborGenerationStagesDone(IntVec2 const& chunkCoords, int numStagesRequired) const
+{
+	if (numStagesRequired <= 0)
+	{
+		return true;
+	}
+
+	Vec2 camPositionXY(m_camPosition.x, m_camPosition.y);
+	for (int neighborY = chunkCoords.y - 1; neighborY <= chunkCoords.y + 1; neighborY++)
+	{
+		for (int neighborX = chunkCoords.x - 1; neighborX <= chunkCoords.x + 1; neighborX++)
+		{
+			IntVec2 neighborCoords(neighborX, neighborY);
+			if (neighborCoords == chunkCoords || m_activeChunks.find(neighborCoords) != m_activeChunks.end())
+			{
+				continue;
+			}
+
+			std::map<IntVec2, Chunk*>::const_iterator neighborIt = m_initializedChunks.find(neighborCoords);
+			if (neighborIt == m_initializedChunks.end())
+			{
+				Vec2 neighborCenterXY = Chunk::GetChunkCenterXYForChunkCoords(neighborCoords);
+				if (GetDistance2D(neighborCenterXY, camPositionXY) < m_chunkActivationRange)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			Chunk const* neighbor = neighborIt->second;
+			if (!neighbor->m_wasLoadedFromDisk && neighbor->m_numGenerationStagesDone < numStagesRequired)
+			{
+				return false;
+			}
+		}
 	}
+	return true;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 void World::ProcessChunkAfterDiskJob(Chunk* chunk)
@@ -1637,11 +2082,16 @@ void World::QueueForSaving(Chunk* chunk)
 	ChunkDiskSaveJob* newSaveJob = new ChunkDiskSaveJob(chunk);
 	//m_activeChunks.erase(chunk->GetChunkCoordinates());
 
+	JobTelemetry::OnJobQueued(JOB_TELEMETRY_DISK_SAVE, newSaveJob->m_timing);
 	g_theJobSystem->QueueJob(newSaveJob);
+	PerfCounters::Increment(PERF_COUNTER_JOBS_QUEUED);
+	m_jobQueueBytes += GetChunkJobBytes(newSaveJob);
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
+#if !defined(GAME_HEADLESS)
 void World::CreateConstantBufferForMinecraftConstants()
 {
 	m_gameCBO = g_theRenderer->CreateConstantBuffer(sizeof(MinecraftGameConstants));
 }
+#endif
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -1,9 +1,10 @@
 #pragma once
 #include "Game/Chunks.hpp"
 #include "Game/BlockIterator.hpp"
-#include "Engine/Renderer/Shader.hpp"
-#include "Engine/Renderer/ConstantBuffer.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Renderer/Camera.hpp"
 #include <deque>
+#include <mutex>
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 static IntVec2 const NorthStep = IntVec2(0, 1);
@@ -11,15 +12,27 @@ static IntVec2 const SouthStep = IntVec2(0, -1);
 static IntVec2 const EastStep = IntVec2(1, 0);
 static IntVec2 const WestStep = IntVec2(-1, 0);
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
-struct GameRaycastResult3D : public RaycastResult3D
+class ColumnCache;
+class CaveCache;
+class PendingBlockWrites;
+class Flythrough;
+class Shader;
+class ConstantBuffer;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Block raycast hit; keeps its own copy of the impact fields so the simulation needs no engine raycast types
+struct GameRaycastResult3D
 {
-	BlockIterator m_blockImpacted;
+	bool			m_didImpact = false;
+	float			m_impactDist = 0.f;
+	Vec3			m_impactPos;
+	Vec3			m_impactNormal;
+	BlockIterator	m_blockImpacted;
 };
 //--------------------------------------------------------------------------------------------------------------------------------------------------------
 class World
 {
 public:
-	World();
+	World(bool configureJobSystem = true);
 	~World();
 
 	void				Update(float deltaSeconds);
@@ -40,6 +53,9 @@ public:
 	void				LoadGameConfig();
 	void				InitializeShader();
 	int					GetWorldSeed() const;
+	ColumnCache*		GetColumnCache();
+	CaveCache*			GetCaveCache();
+	PendingBlockWrites*	GetPendingBlockWrites();
 
 	//Chunk functions
 	void				RenderChunk();
@@ -58,10 +74,15 @@ public:
 	IntVec2				GetChunkCoordinatesForWorldPosition(Vec3 const& pos) const;
 	bool				ActivateNearestMissingChunk();
 	bool				DoesChunkExist(const IntVec2& chunkCoords);
+	void				GetMissingChunksInActivationRange(std::vector<IntVec2>& out_missingChunkCoords) const;
 	void				DeactivateAllChunks();
 	void 				DeactivateChunk(Chunk* chunk);
 	void				SetChunkConstantsValues();
 	void				InitializeChunk(IntVec2 const& coords);
+	void				QueueReadyGenerationStages();
+	void				ApplyPendingBlockWritesToActiveChunk(Chunk* chunk, std::vector<PendingBlockWrite> const& pendingWrites);
+	void				EvictPendingBlockWritesAround(IntVec2 const& chunkCoords);
+	bool				AreNeighborGenerationStagesDone(IntVec2 const& chunkCoords, int numStagesRequired) const;
 	void 				ProcessChunkAfterDiskJob(Chunk* chunk);
 	void				ProcessChunkAfterDiskLoadJob(Chunk* chunk);
 	void				ProcessChunkAfterDiskSaveJob(Chunk* chunk);
@@ -123,6 +144,16 @@ public:
 	bool						m_showCompass = false;
 	bool						m_freezeRaycast = false;
 	bool						m_placeBlockAtCurrentPos = false;
+	bool						m_configuresJobSystem = true;
+	int							m_numLightQueuePushes = 0;
+	int							m_numLightRecomputes = 0;
+	int64_t						m_jobQueueBytes = 0;
+	Flythrough*					m_flythroughRecording = nullptr;
+	ColumnCache*				m_columnCache = nullptr;
+	CaveCache*					m_caveCache = nullptr;
+	PendingBlockWrites*			m_pendingBlockWrites = nullptr;
+	uint8_t						m_frameActions = 0;
+	uint8_t						m_replayActions = 0;
 	Shader*						m_shader = nullptr;
 	ConstantBuffer*				m_gameCBO = nullptr;
 	GameRaycastResult3D			m_raycastResult;
@@ -144,6 +175,11 @@ public:
 	bool						m_debugDisableHSR = false;
 	bool						m_debugDisableGlowstone = false;
 	bool						m_debugDisableWorldShader = false;
+	bool						m_useNoiseTiles = true;
+	int							m_climateLatticeSpacing = 0;
+	bool						m_useOreVeins = true;
+	bool						m_useWormCaves = false;
+	int							m_spawnGenerationBands = 4;
 	float						m_glowStrength = 0.f;
 	float						m_lightingStrength = 0.f;
 	float						m_fogStartDistance = 0.f;
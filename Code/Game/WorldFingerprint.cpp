@@ -0,0 +1,243 @@
+#include "Game/WorldFingerprint.hpp"
+#include "Game/Chunks.hpp"
+#include "Game/World.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t HashByte(uint64_t hash, uint8_t byte)
+{
+	return (hash ^ byte) * WorldFingerprint::FNV_PRIME;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t HashUint64(uint64_t hash, uint64_t value)
+{
+	for (int byteIndex = 0; byteIndex < 8; byteIndex++)
+	{
+		hash = HashByte(hash, static_cast<uint8_t>(value >> (8 * byteIndex)));
+	}
+	return hash;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+static std::string GetDefaultGoldenPath(int worldSeed, int chunkRadius)
+{
+	return Stringf("Data/Golden/WorldFingerprint_seed%i_radius%i.txt", worldSeed, chunkRadius);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void WorldFingerprint::RegisterCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("WorldFingerprint", WorldFingerprint::Event_WorldFingerprint);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// WorldFingerprint seed=1 radius=4 golden=Data/Golden/WorldFingerprint_seed1_radius4.txt update=false
+//	Generates the (2*radius)^2 chunks around the origin in a private world, activates them all and drains the lighting queue,
+//	then hashes every chunk. Compares against the golden file, or rewrites it with update=true. Chunks on the edge of the
+//	square have no outer neighbors, so their light differs from an endless world but is still deterministic.
+//	The golden for the defaults is committed; a change that alters generation on purpose rewrites it in the same commit.
+bool WorldFingerprint::Event_WorldFingerprint(EventArgs& args)
+{
+	int worldSeed = args.GetValue("seed", 1);
+	int chunkRadius = std::max(args.GetValue("radius", 4), 1);
+	std::string goldenPath = args.GetValue("golden", GetDefaultGoldenPath(worldSeed, chunkRadius));
+	bool shouldUpdate = args.GetValue("update", false);
+
+	double startTime = GetCurrentTimeSeconds();
+	World* world = new World(false);
+	world->m_worldSeed = worldSeed;
+
+	for (int chunkY = -chunkRadius; chunkY < chunkRadius; chunkY++)
+	{
+		for (int chunkX = -chunkRadius; chunkX < chunkRadius; chunkX++)
+		{
+			IntVec2 chunkCoords(chunkX, chunkY);
+			Chunk* chunk = new Chunk(world, chunkCoords);
+			chunk->Generateblocks();
+			world->m_initializedChunks[chunkCoords] = chunk;
+		}
+	}
+
+	//Trees that straddle chunks are only complete once every chunk took the blocks its neighbors left it, as in the light stage
+	for (std::map<IntVec2, Chunk*>::iterator chunkIt = world->m_initializedChunks.begin(); chunkIt != world->m_initializedChunks.end(); ++chunkIt)
+	{
+		chunkIt->second->ApplyPendingBlockWrites(false);
+	}
+
+	std::vector<ChunkFingerprint> chunkFingerprints;
+	chunkFingerprints.reserve(4 * chunkRadius * chunkRadius);
+	for (int chunkY = -chunkRadius; chunkY < chunkRadius; chunkY++)
+	{
+		for (int chunkX = -chunkRadius; chunkX < chunkRadius; chunkX++)
+		{
+			ChunkFingerprint fingerprint;
+			fingerprint.m_chunkCoords = IntVec2(chunkX, chunkY);
+			fingerprint.m_blocksHash = HashChunkBlocks(world->m_initializedChunks[fingerprint.m_chunkCoords]);
+			chunkFingerprints.push_back(fingerprint);
+		}
+	}
+	double generateSeconds = GetCurrentTimeSeconds() - startTime;
+
+	for (int chunkIndex = 0; chunkIndex < (int)chunkFingerprints.size(); chunkIndex++)
+	{
+		world->ActivateNewChunk(chunkFingerprints[chunkIndex].m_chunkCoords);
+	}
+	world->ProcessDirtyLighting();
+	for (int chunkIndex = 0; chunkIndex < (int)chunkFingerprints.size(); chunkIndex++)
+	{
+		ChunkFingerprint& fingerprint = chunkFingerprints[chunkIndex];
+		fingerprint.m_lightHash = HashChunkLight(world->GetChunkForChunkCoordinates(fingerprint.m_chunkCoords));
+	}
+	double totalSeconds = GetCurrentTimeSeconds() - startTime;
+	delete world;
+
+	uint64_t regionBlocksHash = 0;
+	uint64_t regionLightHash = 0;
+	HashRegion(chunkFingerprints, regionBlocksHash, regionLightHash);
+	PrintToConsole(Stringf("WorldFingerprint seed=%i radius=%i: blocks=%016llx, light=%016llx (%i chunks, generate=%.2fs, total=%.2fs)",
+		worldSeed, chunkRadius, (unsigned long long)regionBlocksHash, (unsigned long long)regionLightHash,
+		(int)chunkFingerprints.size(), generateSeconds, totalSeconds), Rgba8(0, 255, 255, 255));
+
+	if (shouldUpdate)
+	{
+		bool wasSaved = SaveToFile(goldenPath, worldSeed, chunkRadius, chunkFingerprints);
+		PrintToConsole(Stringf("WorldFingerprint: %s golden file %s", wasSaved ? "wrote" : "FAILED to write", goldenPath.c_str()),
+			wasSaved ? Rgba8(0, 255, 255, 255) : Rgba8(255, 0, 0, 255));
+		return wasSaved;
+	}
+
+	std::vector<ChunkFingerprint> goldenFingerprints;
+	if (!LoadFromFile(goldenPath, goldenFingerprints))
+	{
+		PrintToConsole(Stringf("WorldFingerprint: no golden file at %s, run with update=true to create it", goldenPath.c_str()), Rgba8(255, 255, 0, 255));
+		return false;
+	}
+
+	constexpr int MAX_MISMATCHES_PRINTED = 10;
+	int numBlockMismatches = 0;
+	int numLightMismatches = 0;
+	int numMissing = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)chunkFingerprints.size(); chunkIndex++)
+	{
+		ChunkFingerprint const& fingerprint = chunkFingerprints[chunkIndex];
+		auto goldenIt = std::find_if(goldenFingerprints.begin(), goldenFingerprints.end(), [&fingerprint](ChunkFingerprint const& golden)
+			{
+				return golden.m_chunkCoords == fingerprint.m_chunkCoords;
+			});
+		if (goldenIt == goldenFingerprints.end())
+		{
+			numMissing++;
+			continue;
+		}
+
+		bool blocksMatch = goldenIt->m_blocksHash == fingerprint.m_blocksHash;
+		bool lightMatches = goldenIt->m_lightHash == fingerprint.m_lightHash;
+		numBlockMismatches += blocksMatch ? 0 : 1;
+		numLightMismatches += lightMatches ? 0 : 1;
+		if ((!blocksMatch || !lightMatches) && (numBlockMismatches + numLightMismatches) <= MAX_MISMATCHES_PRINTED)
+		{
+			PrintToConsole(Stringf("WorldFingerprint: chunk (%i,%i) differs:%s%s", fingerprint.m_chunkCoords.x, fingerprint.m_chunkCoords.y,
+				blocksMatch ? "" : " blocks", lightMatches ? "" : " light"), Rgba8(255, 0, 0, 255));
+		}
+	}
+
+	bool isMatch = (numBlockMismatches == 0 && numLightMismatches == 0 && numMissing == 0 && goldenFingerprints.size() == chunkFingerprints.size());
+	PrintToConsole(Stringf("WorldFingerprint: %s golden %s (blockMismatches=%i, lightMismatches=%i, missingFromGolden=%i)",
+		isMatch ? "MATCHES" : "DRIFTED FROM", goldenPath.c_str(), numBlockMismatches, numLightMismatches, numMissing),
+		isMatch ? Rgba8(0, 255, 0, 255) : Rgba8(255, 0, 0, 255));
+	return isMatch;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t WorldFingerprint::HashChunkBlocks(Chunk const* chunk)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCKS_TOTAL; blockIndex++)
+	{
+		hash = HashByte(hash, chunk->m_blocks[blockIndex].GetTypeID());
+	}
+	return hash;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t WorldFingerprint::HashChunkLight(Chunk const* chunk)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for (int blockIndex = 0; blockIndex < CHUNK_BLOCKS_TOTAL; blockIndex++)
+	{
+		Block const& block = chunk->m_blocks[blockIndex];
+		hash = HashByte(hash, block.GetIndoorLightInfluence());
+		hash = HashByte(hash, block.GetOutdoorLightInfluence());
+		hash = HashByte(hash, block.IsBlockSky() ? 1 : 0);
+	}
+	return hash;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+void WorldFingerprint::HashRegion(std::vector<ChunkFingerprint> const& chunkFingerprints, uint64_t& out_blocksHash, uint64_t& out_lightHash)
+{
+	out_blocksHash = FNV_OFFSET_BASIS;
+	out_lightHash = FNV_OFFSET_BASIS;
+	for (int chunkIndex = 0; chunkIndex < (int)chunkFingerprints.size(); chunkIndex++)
+	{
+		out_blocksHash = HashUint64(out_blocksHash, chunkFingerprints[chunkIndex].m_blocksHash);
+		out_lightHash = HashUint64(out_lightHash, chunkFingerprints[chunkIndex].m_lightHash);
+	}
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Golden file format, one record per line:
+//	# comment
+//	chunk <x> <y> <blocksHash> <lightHash>		hashes as 16 hex digits
+bool WorldFingerprint::SaveToFile(std::string const& filePath, int worldSeed, int chunkRadius, std::vector<ChunkFingerprint> const& chunkFingerprints)
+{
+	uint64_t regionBlocksHash = 0;
+	uint64_t regionLightHash = 0;
+	HashRegion(chunkFingerprints, regionBlocksHash, regionLightHash);
+
+	std::string text = Stringf("# WorldFingerprint seed=%i radius=%i blocks=%016llx light=%016llx\n", worldSeed, chunkRadius,
+		(unsigned long long)regionBlocksHash, (unsigned long long)regionLightHash);
+	for (int chunkIndex = 0; chunkIndex < (int)chunkFingerprints.size(); chunkIndex++)
+	{
+		ChunkFingerprint const& fingerprint = chunkFingerprints[chunkIndex];
+		text += Stringf("chunk %i %i %016llx %016llx\n", fingerprint.m_chunkCoords.x, fingerprint.m_chunkCoords.y,
+			(unsigned long long)fingerprint.m_blocksHash, (unsigned long long)fingerprint.m_lightHash);
+	}
+
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), errorCode);
+	std::vector<uint8_t> buffer(text.begin(), text.end());
+	return FileWriteFromBuffer(buffer, filePath);
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+bool WorldFingerprint::LoadFromFile(std::string const& filePath, std::vector<ChunkFingerprint>& out_chunkFingerprints)
+{
+	out_chunkFingerprints.clear();
+	if (!DoesFileExist(filePath))
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> buffer;
+	FileReadToBuffer(buffer, filePath);
+	std::istringstream stream(std::string(buffer.begin(), buffer.end()));
+
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		std::istringstream lineStream(line);
+		std::string recordType;
+		lineStream >> recordType;
+		if (recordType != "chunk")
+		{
+			continue;
+		}
+
+		ChunkFingerprint fingerprint;
+		lineStream >> fingerprint.m_chunkCoords.x >> fingerprint.m_chunkCoords.y >> std::hex >> fingerprint.m_blocksHash >> fingerprint.m_lightHash;
+		if (!lineStream.fail())
+		{
+			out_chunkFingerprints.push_back(fingerprint);
+		}
+	}
+	return !out_chunkFingerprints.empty();
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
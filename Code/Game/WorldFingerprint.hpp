@@ -0,0 +1,39 @@
+#pragma once
+#include "Engine/Core/EventSytem.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class Chunk;
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+struct ChunkFingerprint
+{
+	IntVec2		m_chunkCoords;
+	uint64_t	m_blocksHash = 0;
+	uint64_t	m_lightHash = 0;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+// Stable FNV-1a hashes of generated terrain, per chunk and per region, for proving that an optimization of
+// Generateblocks, AddCaves or the lighting code leaves the world unchanged. The block hash covers block types only;
+// the light hash covers indoor/outdoor light and the sky flag after ProcessDirtyLighting has drained.
+//--------------------------------------------------------------------------------------------------------------------------------------------------------
+class WorldFingerprint
+{
+public:
+	static void			RegisterCommands();
+	static bool			Event_WorldFingerprint(EventArgs& args);
+
+	static uint64_t		HashChunkBlocks(Chunk const* chunk);
+	static uint64_t		HashChunkLight(Chunk const* chunk);
+	static void			HashRegion(std::vector<ChunkFingerprint> const& chunkFingerprints, uint64_t& out_blocksHash, uint64_t& out_lightHash);
+
+	static bool			SaveToFile(std::string const& filePath, int worldSeed, int chunkRadius, std::vector<ChunkFingerprint> const& chunkFingerprints);
+	static bool			LoadFromFile(std::string const& filePath, std::vector<ChunkFingerprint>& out_chunkFingerprints);
+
+public:
+	static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+};
+//--------------------------------------------------------------------------------------------------------------------------------------------------------